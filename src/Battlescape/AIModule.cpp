@@ -31,6 +31,7 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/Profiler.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
@@ -200,6 +201,7 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	Profiler::Scope profile(PROF_AI_THINK);
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -1108,30 +1110,30 @@ int AIModule::getSpottingUnits(const Position& pos) const
 {
 	// if we don't actually occupy the position being checked, we need to do a virtual LOF check.
 	bool checking = pos != _unit->getPosition();
-	int tally = 0;
+	std::vector<LineOfFireQuery> queries;
 	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
 		if (validTarget(*i, false, false))
 		{
 			int dist = Position::distance2d(pos, (*i)->getPosition());
 			if (dist > 20) continue;
-			Position originVoxel = _save->getTileEngine()->getSightOriginVoxel(*i);
-			originVoxel.z -= 2;
-			Position targetVoxel;
-			if (checking)
-			{
-				if (_save->getTileEngine()->canTargetUnit(&originVoxel, _save->getTile(pos), &targetVoxel, *i, false, _unit))
-				{
-					tally++;
-				}
-			}
-			else
-			{
-				if (_save->getTileEngine()->canTargetUnit(&originVoxel, _save->getTile(pos), &targetVoxel, *i, false))
-				{
-					tally++;
-				}
-			}
+			LineOfFireQuery query;
+			query.origin = _save->getTileEngine()->getSightOriginVoxel(*i);
+			query.origin.z -= 2;
+			query.tile = _save->getTile(pos);
+			query.excludeUnit = *i;
+			query.potentialUnit = checking ? _unit : 0;
+			queries.push_back(query);
+		}
+	}
+	_save->getTileEngine()->canTargetUnits(queries);
+
+	int tally = 0;
+	for (std::vector<LineOfFireQuery>::const_iterator i = queries.begin(); i != queries.end(); ++i)
+	{
+		if (i->result)
+		{
+			tally++;
 		}
 	}
 	return tally;
@@ -1408,6 +1410,28 @@ bool AIModule::selectSpottedUnitForSniper()
 		costThrow += _attackAction->actor->getActionTUs(BA_PRIME, costThrow.weapon);
 	}
 
+	// trace the lines of fire to all targets at once, scoreFiringMode picks them up
+	_lineOfFire.clear();
+	if (_attackAction->weapon)
+	{
+		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		{
+			if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) && (*i)->getTurnsLeftSpottedForSnipers())
+			{
+				BattleAction shot = *_attackAction;
+				shot.type = BA_SNAPSHOT;
+				shot.target = (*i)->getPosition();
+				LineOfFireQuery query;
+				query.origin = _save->getTileEngine()->getOriginVoxel(shot, 0);
+				query.tile = (*i)->getTile();
+				query.excludeUnit = _unit;
+				query.potentialUnit = *i;
+				_lineOfFire.push_back(query);
+			}
+		}
+		_save->getTileEngine()->canTargetUnits(_lineOfFire);
+	}
+
 	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
 		if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) && (*i)->getTurnsLeftSpottedForSnipers())
@@ -1431,6 +1455,8 @@ bool AIModule::selectSpottedUnitForSniper()
 		}
 	}
 
+	_lineOfFire.clear();
+
 	int numberOfTargets = static_cast<int>(spottedTargets.size());
 
 	if (numberOfTargets) // Now that we have a list of valid targets, pick one and return.
@@ -1546,7 +1572,21 @@ int AIModule::scoreFiringMode(BattleAction *action, BattleUnit *target, bool che
 		}
 		else
 		{
-			if (!_save->getTileEngine()->canTargetUnit(&origin, target->getTile(), &targetPosition, _unit, false, target))
+			bool lineOfFire;
+			std::vector<LineOfFireQuery>::const_iterator known = _lineOfFire.begin();
+			while (known != _lineOfFire.end() && (known->potentialUnit != target || known->origin != origin))
+			{
+				++known;
+			}
+			if (known != _lineOfFire.end())
+			{
+				lineOfFire = known->result;
+			}
+			else
+			{
+				lineOfFire = _save->getTileEngine()->canTargetUnit(&origin, target->getTile(), &targetPosition, _unit, false, target);
+			}
+			if (!lineOfFire)
 			{
 				return 0;
 			}
@@ -1814,13 +1854,16 @@ bool AIModule::findFirePoint()
 		return false;
 	std::vector<Position> randomTileSearch = _save->getTileSearch();
 	RNG::shuffle(randomTileSearch);
-	Position target;
 	const int BASE_SYSTEMATIC_SUCCESS = 100;
 	const int FAST_PASS_THRESHOLD = 125;
 	bool waitIfOutsideWeaponRange = _unit->getGeoscapeSoldier() ? false : _unit->getUnitRules()->waitIfOutsideWeaponRange();
 	bool extendedFireModeChoiceEnabled = _save->getBattleGame()->getMod()->getAIExtendedFireModeChoice();
 	int bestScore = 0;
 	_attackAction->type = BA_RETHINK;
+
+	// trace from all candidate positions at once, then score them in the same order as before
+	std::vector<Position> candidates;
+	std::vector<LineOfFireQuery> queries;
 	for (std::vector<Position>::const_iterator i = randomTileSearch.begin(); i != randomTileSearch.end(); ++i)
 	{
 		Position pos = _unit->getPosition() + *i;
@@ -1828,13 +1871,24 @@ bool AIModule::findFirePoint()
 		if (tile == 0  ||
 			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
 			continue;
-		int score = 0;
+		LineOfFireQuery query;
 		// i should really make a function for this
-		Position origin = pos.toVoxel() +
+		query.origin = pos.toVoxel() +
 			// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
 			Position(8,8, _unit->getHeight() + _unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+		query.tile = _aggroTarget->getTile();
+		query.excludeUnit = _unit;
+		candidates.push_back(pos);
+		queries.push_back(query);
+	}
+	_save->getTileEngine()->canTargetUnits(queries);
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		Position pos = candidates[i];
+		int score = 0;
 
-		if (_save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit, false))
+		if (queries[i].result)
 		{
 			_save->getPathfinding()->calculate(_unit, pos);
 			// can move here
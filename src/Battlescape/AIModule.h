@@ -20,6 +20,7 @@
 #include <yaml-cpp/yaml.h>
 #include "BattlescapeGame.h"
 #include "Position.h"
+#include "TileEngine.h"
 #include "../Savegame/BattleUnit.h"
 #include <vector>
 
@@ -55,6 +56,7 @@ private:
 	std::vector<int> _reachable, _reachableWithAttack, _wasHitBy;
 	BattleActionType _reserve;
 	UnitFaction _targetFaction;
+	std::vector<LineOfFireQuery> _lineOfFire;
 
 	bool selectPointNearTargetLeeroy(BattleUnit *target) const;
 	int selectNearestTargetLeeroy();
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleBenchmark.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "BattlescapeGame.h"
+#include "BattlescapeState.h"
+#include "BriefingState.h"
+#include "DebriefingState.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Engine/Timer.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up a battle benchmark.
+ * @param game Pointer to the core game, created with a dummy video driver.
+ * @param filename Save file, relative to the master mod user folder.
+ * @param turns Number of full turns to play.
+ * @param seed RNG seed, so runs can be repeated and compared.
+ */
+BattleBenchmark::BattleBenchmark(Game *game, const std::string &filename, int turns, uint64_t seed) : _game(game), _filename(filename), _turns(turns), _seed(seed)
+{
+}
+
+/**
+ *
+ */
+BattleBenchmark::~BattleBenchmark()
+{
+}
+
+/**
+ * Loads the mods and the save, then runs the battlescape state
+ * machine as fast as it goes until the turns are played or
+ * the battle ends. The final RNG state is printed along with
+ * the timings: two runs with the same seed must match it.
+ * @return Process exit code.
+ */
+int BattleBenchmark::run()
+{
+	Log(LOG_INFO) << "Battle benchmark: loading data...";
+	Options::updateMods();
+	_game->loadMods();
+	_game->loadLanguages();
+
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(_filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle benchmark: " << e.what();
+		delete save;
+		return EXIT_FAILURE;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Battle benchmark: " << e.what();
+		delete save;
+		return EXIT_FAILURE;
+	}
+	_game->setSavedGame(save);
+
+	SavedBattleGame *battle = save->getSavedBattle();
+	if (battle == 0)
+	{
+		Log(LOG_ERROR) << "Battle benchmark: " << _filename << " is not a battlescape save.";
+		return EXIT_FAILURE;
+	}
+	battle->loadMapResources(_game->getMod());
+	RNG::setSeed(_seed);
+
+	Options::baseXResolution = Options::baseXBattlescape;
+	Options::baseYResolution = Options::baseYBattlescape;
+	_game->getScreen()->resetDisplay(false);
+	BattlescapeState *bs = new BattlescapeState;
+	_game->setState(bs);
+	battle->setBattleState(bs);
+
+	Log(LOG_INFO) << "Battle benchmark: playing " << _turns << " turns of " << _filename << " with seed " << _seed;
+	Timer::fastForward = true;
+	Profiler::setEnabled(true);
+
+	const int firstTurn = battle->getTurn();
+	const int lastTurn = firstTurn + _turns;
+	int turn = firstTurn;
+	Uint64 cycles = 0;
+	bool finished = false;
+	auto start = std::chrono::steady_clock::now();
+	while (true)
+	{
+		_game->thinkHeadless();
+		++cycles;
+
+		State *top = _game->getTopState();
+		// don't touch the battle after it's over, the debriefing owns it now
+		if (top == 0 || dynamic_cast<DebriefingState*>(top) || dynamic_cast<BriefingState*>(top))
+		{
+			// the battle (or this stage of it) is over
+			finished = true;
+			break;
+		}
+		turn = battle->getTurn();
+		if (turn >= lastTurn)
+		{
+			break;
+		}
+		if (top == bs)
+		{
+			BattlescapeGame *battleGame = bs->getBattleGame();
+			if (battle->getSide() == FACTION_PLAYER && !battleGame->isBusy())
+			{
+				battleGame->requestEndTurn(false);
+			}
+		}
+		else
+		{
+			// popups, next turn screens, etc.
+			_game->dismissTopState();
+		}
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	Timer::fastForward = false;
+
+	std::ostringstream report;
+	report << "Battle benchmark: " << _filename << ", seed " << _seed << std::endl;
+	if (finished)
+	{
+		report << "Battle ended during turn " << turn << " (started at turn " << firstTurn << ")" << std::endl;
+	}
+	else
+	{
+		report << "Played turns " << firstTurn << " to " << lastTurn - 1 << std::endl;
+	}
+	report << "Cycles: " << cycles << ", wall-clock: " << elapsed / 1000.0 << " ms" << std::endl;
+	report << "Final RNG state: " << RNG::getSeed() << std::endl;
+	Profiler::report(report);
+	Profiler::setEnabled(false);
+
+	std::cout << report.str();
+	Log(LOG_INFO) << report.str();
+	return EXIT_SUCCESS;
+}
+
+}
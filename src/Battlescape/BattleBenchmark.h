@@ -0,0 +1,50 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+class Game;
+
+/**
+ * Plays a saved battle without video, input or frame pacing,
+ * so AI turns and reaction fire can be measured in CI.
+ * Player turns are ended immediately, popups are dismissed
+ * and the time spent in the engine's hot paths is reported.
+ */
+class BattleBenchmark
+{
+private:
+	Game *_game;
+	std::string _filename;
+	int _turns;
+	uint64_t _seed;
+public:
+	/// Creates a benchmark for a battlescape save.
+	BattleBenchmark(Game *game, const std::string &filename, int turns, uint64_t seed);
+	/// Cleans up the benchmark.
+	~BattleBenchmark();
+	/// Loads the save, plays the turns and prints the timings.
+	int run();
+};
+
+}
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "BattleState.h"
+#include "BattlescapeGame.h"
+#include "Map.h"
 
 namespace OpenXcom
 {
@@ -84,6 +86,15 @@ void BattleState::think()
 
 }
 
+/**
+ * Marks the parts of the map changed by the last think to be drawn again.
+ * By default the whole map is drawn again.
+ */
+void BattleState::invalidateMap()
+{
+	_parent->getMap()->invalidate();
+}
+
 /**
  * Gets the action result. Returns error messages or an empty string when everything went fine.
  * @return Error or empty string when everything is fine.
@@ -46,6 +46,8 @@ public:
 	virtual void cancel();
 	/// Runs state functionality every cycle.
 	virtual void think();
+	/// Marks the parts of the map changed by the last think.
+	virtual void invalidateMap();
 	/// Gets a copy of the action.
 	const BattleAction& getAction() const;
 };
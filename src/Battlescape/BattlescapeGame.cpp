@@ -176,7 +176,7 @@ bool BattleActionCost::spendTU(std::string *message)
  * @param parentState Pointer to the parent battlescape state.
  */
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) :
-	_save(save), _parentState(parentState),
+	_save(save), _parentState(parentState), _stateGeneration(0),
 	_playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false),
 	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
 {
@@ -1075,11 +1075,17 @@ void BattlescapeGame::handleState()
 			endTurn();
 			return;
 		}
+		// the state can be popped during think, don't touch it again unless it is still current
+		Uint32 generation = _stateGeneration;
+		_states.front()->think();
+		if (_stateGeneration == generation)
+		{
+			_states.front()->invalidateMap(); // the state knows what it changed
+		}
 		else
 		{
-			_states.front()->think();
+			getMap()->invalidate(); // redraw map
 		}
-		getMap()->invalidate(); // redraw map
 	}
 }
 
@@ -1089,6 +1095,7 @@ void BattlescapeGame::handleState()
  */
 void BattlescapeGame::statePushFront(BattleState *bs)
 {
+	++_stateGeneration;
 	_states.push_front(bs);
 	bs->init();
 }
@@ -1101,6 +1108,7 @@ void BattlescapeGame::statePushNext(BattleState *bs)
 {
 	if (_states.empty())
 	{
+		++_stateGeneration;
 		_states.push_front(bs);
 		bs->init();
 	}
@@ -1119,6 +1127,7 @@ void BattlescapeGame::statePushBack(BattleState *bs)
 {
 	if (_states.empty())
 	{
+		++_stateGeneration;
 		_states.push_front(bs);
 		// end turn request?
 		if (_states.front() == 0)
@@ -1164,6 +1173,7 @@ void BattlescapeGame::popState()
 		_parentState->warning(action.result);
 		actionFailed = true;
 	}
+	++_stateGeneration;
 	_deleted.push_back(first);
 	_states.pop_front();
 	first->deinit();
@@ -162,6 +162,7 @@ private:
 	SavedBattleGame *_save;
 	BattlescapeState *_parentState;
 	std::list<BattleState*> _states, _deleted;
+	Uint32 _stateGeneration;
 	bool _playerPanicHandled;
 	int _AIActionCounter;
 	BattleAction _currentAction;
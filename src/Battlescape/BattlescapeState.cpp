@@ -2200,7 +2200,7 @@ void BattlescapeState::handleItemClick(BattleItem *item, bool middleClick)
  */
 void BattlescapeState::animate()
 {
-	_map->animate(!_battleGame->isBusy());
+	_map->animate();
 
 	blinkVisibleUnitButtons();
 	blinkHealthBar();
@@ -388,6 +388,14 @@ void ExplosionBState::think()
 	}
 }
 
+/**
+ * Marks the explosion sprites to be drawn again.
+ */
+void ExplosionBState::invalidateMap()
+{
+	_parent->getMap()->invalidateExplosions();
+}
+
 /**
  * Explosions cannot be cancelled.
  */
@@ -20,6 +20,7 @@
 #include <cmath>
 #include "ItemSprite.h"
 #include "../Engine/SurfaceSet.h"
+#include "../Engine/ScriptBlitCache.h"
 #include "../Mod/RuleSoldier.h"
 #include "../Mod/Unit.h"
 #include "../Mod/RuleItem.h"
@@ -40,11 +41,13 @@ namespace OpenXcom
  * @param height Height in pixels.
  * @param x X position in pixels.
  * @param y Y position in pixels.
+ * @param cache Optional cache of recolored sprites.
  */
-ItemSprite::ItemSprite(Surface* dest, Mod* mod, int frame) :
+ItemSprite::ItemSprite(Surface* dest, Mod* mod, int frame, ScriptBlitCache* cache) :
 	_itemSurface(mod->getSurfaceSet("FLOOROB.PCK")),
 	_animationFrame(frame),
-	_dest(dest)
+	_dest(dest),
+	_cache(cache)
 {
 
 }
@@ -68,7 +71,14 @@ void ItemSprite::draw(BattleItem* item, int x, int y, int shade)
 	{
 		ScriptWorkerBlit work;
 		BattleItem::ScriptFill(&work, item, BODYPART_ITEM_FLOOR, _animationFrame, shade);
-		work.executeBlit(sprite, _dest, x, y, shade);
+		if (_cache)
+		{
+			_cache->executeBlit(work, sprite, _dest, x, y, shade, GraphSubset{ _dest->getWidth(), _dest->getHeight() });
+		}
+		else
+		{
+			work.executeBlit(sprite, _dest, x, y, shade);
+		}
 	}
 }
 
@@ -27,6 +27,7 @@ class BattleUnit;
 class BattleItem;
 class SurfaceSet;
 class Mod;
+class ScriptBlitCache;
 
 /**
  * A class that renders a specific unit, given its render rules
@@ -38,10 +39,11 @@ private:
 	SurfaceSet *_itemSurface;
 	int _animationFrame;
 	Surface *_dest;
+	ScriptBlitCache *_cache;
 
 public:
 	/// Creates a new ItemSprite at the specified position and size.
-	ItemSprite(Surface* dest, Mod* mod, int frame);
+	ItemSprite(Surface* dest, Mod* mod, int frame, ScriptBlitCache* cache = nullptr);
 	/// Cleans up the ItemSprite.
 	~ItemSprite();
 	/// Draws the item.
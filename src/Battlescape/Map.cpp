@@ -36,6 +36,7 @@
 #include "../Engine/Screen.h"
 #include "../Engine/ShaderDraw.h"
 #include "../Engine/ShaderMove.h"
+#include "../Engine/ScriptBlitCache.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -53,6 +54,7 @@
 #include "../Interface/Text.h"
 #include "../fmath.h"
 #include "../fallthrough.h"
+#include <cstring>
 
 
 /*
@@ -98,7 +100,7 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_game(game), _arrow(0), _anyIndicator(false), _isAltPressed(false),
 	_selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0),
 	_projectile(0), _followProjectile(true), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight),
-	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _showObstacles(false)
+	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _drawnState(), _dirtyAreas(), _unitAreas(), _projectileArea(), _explosionArea(), _redrawSurface(0), _spriteCache(new ScriptBlitCache()), _showObstacles(false)
 {
 	_iconHeight = _game->getMod()->getInterface("battlescape")->getElement("icons")->h;
 	_iconWidth = _game->getMod()->getInterface("battlescape")->getElement("icons")->w;
@@ -187,6 +189,8 @@ Map::~Map()
 	delete _message;
 	delete _camera;
 	delete _txtAccuracy;
+	delete _spriteCache;
+	delete _redrawSurface;
 }
 
 /**
@@ -237,30 +241,102 @@ void Map::think()
 	_obstacleTimer->think(0, this);
 }
 
+/**
+ * Grows a rectangle so it also covers another one.
+ * @param rect Rectangle to grow, empty when its width is zero.
+ * @param other Rectangle to add.
+ */
+static void uniteRect(SDL_Rect &rect, const SDL_Rect &other)
+{
+	if (other.w <= 0 || other.h <= 0)
+	{
+		return;
+	}
+	if (rect.w <= 0 || rect.h <= 0)
+	{
+		rect = other;
+		return;
+	}
+	int x1 = std::min<int>(rect.x, other.x);
+	int y1 = std::min<int>(rect.y, other.y);
+	int x2 = std::max<int>(rect.x + rect.w, other.x + other.w);
+	int y2 = std::max<int>(rect.y + rect.h, other.y + other.h);
+	rect.x = x1;
+	rect.y = y1;
+	rect.w = x2 - x1;
+	rect.h = y2 - y1;
+}
+
+/**
+ * Clips a rectangle to the surface bounds.
+ * @param rect Rectangle to clip, has zero width if nothing is left.
+ * @param width Surface width.
+ * @param height Surface height.
+ */
+static void clipRect(SDL_Rect &rect, int width, int height)
+{
+	int x1 = Clamp<int>(rect.x, 0, width);
+	int y1 = Clamp<int>(rect.y, 0, height);
+	int x2 = Clamp<int>(rect.x + rect.w, 0, width);
+	int y2 = Clamp<int>(rect.y + rect.h, 0, height);
+	rect.x = x1;
+	rect.y = y1;
+	rect.w = x2 > x1 && y2 > y1 ? x2 - x1 : 0;
+	rect.h = x2 > x1 && y2 > y1 ? y2 - y1 : 0;
+}
+
+/**
+ * Checks if two rectangles share any pixel.
+ * @param rect First rectangle.
+ * @param other Second rectangle.
+ * @return True if they overlap.
+ */
+static bool overlapRect(const SDL_Rect &rect, const SDL_Rect &other)
+{
+	return rect.x < other.x + other.w && other.x < rect.x + rect.w &&
+		rect.y < other.y + other.h && other.y < rect.y + rect.h;
+}
+
+/**
+ * Checks if two rectangles are the same.
+ * @param rect First rectangle.
+ * @param other Second rectangle.
+ * @return True if they are equal.
+ */
+static bool sameRect(const SDL_Rect &rect, const SDL_Rect &other)
+{
+	return rect.x == other.x && rect.y == other.y && rect.w == other.w && rect.h == other.h;
+}
+
+/**
+ * Checks if the floor sprite of an item changes with the animation frame.
+ * @param item Item to check, can be null.
+ * @return True if its sprite scripts read the animation frame.
+ */
+static bool isFloorSpriteAnimated(const BattleItem *item)
+{
+	if (!item)
+	{
+		return false;
+	}
+	// the animation frame is the fifth parameter of both scripts
+	const RuleItem *rule = item->getRules();
+	return rule->getScript<ModScript::SelectItemSprite>().isParamUsed(4) || rule->getScript<ModScript::RecolorItemSprite>().isParamUsed(4);
+}
+
 /**
  * Draws the whole map, part by part.
+ * When only parts of the map were marked dirty and nothing that affects
+ * the whole view changed since the last draw, only the tiles covering
+ * the dirty areas are drawn again and the rest of the surface is kept.
  */
 void Map::draw()
 {
-	if (!_redraw)
+	if (!_redraw && _dirtyAreas.empty())
 	{
 		return;
 	}
 
-	// normally we'd call for a Surface::draw();
-	// but we don't want to clear the background with colour 0, which is transparent (aka black)
-	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
-	// Note: un-hardcoded the color from 15 to ruleset value, default 15
-	_redraw = false;
-	ShaderDrawFunc(
-		[](Uint8& dest, Uint8 color)
-		{
-			dest = color;
-		},
-		ShaderSurface(this),
-		ShaderScalar<Uint8>(Palette::blockOffset(0) + _bgColor)
-	);
-
 	Tile *t;
 
 	_projectileInFOV = _save->getDebugMode();
@@ -286,16 +362,376 @@ void Map::draw()
 		}
 	}
 
-	if ((_save->getSelectedUnit() && _save->getSelectedUnit()->getVisible()) || _unitDying || _save->getSide() == FACTION_PLAYER || _save->getDebugMode() || _projectileInFOV || _explosionInFOV)
+	bool terrain = (_save->getSelectedUnit() && _save->getSelectedUnit()->getVisible()) || _unitDying || _save->getSide() == FACTION_PLAYER || _save->getDebugMode() || _projectileInFOV || _explosionInFOV;
+
+	MapDrawnState state = getDrawnState(terrain);
+	bool partial = !_redraw && terrain && state == _drawnState;
+	std::vector<SDL_Rect> areas;
+	areas.swap(_dirtyAreas);
+	_redraw = false;
+	_drawnState = state;
+
+	// normally we'd call for a Surface::draw();
+	// but we don't want to clear the background with colour 0, which is transparent (aka black)
+	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
+	// Note: un-hardcoded the color from 15 to ruleset value, default 15
+	Uint8 background = Palette::blockOffset(0) + _bgColor;
+	if (partial)
 	{
-		drawTerrain(this);
+		// tiles are drawn whole and spill over the dirty area, so they are drawn on a spare surface and only the area is copied back
+		if (!_redrawSurface || _redrawSurface->getWidth() != getWidth() || _redrawSurface->getHeight() != getHeight())
+		{
+			delete _redrawSurface;
+			_redrawSurface = new Surface(getWidth(), getHeight());
+		}
+		for (SDL_Rect area : areas)
+		{
+			for (int y = area.y; y < area.y + area.h; ++y)
+			{
+				memset(_redrawSurface->getBuffer() + y * _redrawSurface->getPitch() + area.x, background, area.w);
+			}
+			drawTerrain(_redrawSurface, area);
+			for (int y = area.y; y < area.y + area.h; ++y)
+			{
+				memcpy(getBuffer() + y * getPitch() + area.x, _redrawSurface->getBuffer() + y * _redrawSurface->getPitch() + area.x, area.w);
+			}
+			if (area.w == getWidth() && area.h == getHeight())
+			{
+				// the camera moved, everything was drawn
+				break;
+			}
+		}
+		_drawnState.cameraOffset = _camera->getMapOffset();
 	}
 	else
 	{
-		_message->blit(this->getSurface());
+		ShaderDraw<helper::Fill>(
+			ShaderSurface(this),
+			ShaderScalar<Uint8>(background)
+		);
+
+		if (terrain)
+		{
+			SDL_Rect area = { 0, 0, (Uint16)getWidth(), (Uint16)getHeight() };
+			drawTerrain(this, area);
+			_drawnState.cameraOffset = _camera->getMapOffset();
+		}
+		else
+		{
+			_message->blit(this->getSurface());
+		}
+	}
+	_projectileArea = getProjectileArea();
+	_explosionArea = getExplosionArea();
+}
+
+/**
+ * Redraws the dirty areas of the map, if any, before blitting it.
+ * @param surface Pointer to surface to blit onto.
+ */
+void Map::blit(SDL_Surface *surface)
+{
+	if (!_dirtyAreas.empty() && _visible && !_hidden)
+	{
+		draw();
+	}
+	Surface::blit(surface);
+}
+
+/**
+ * Marks a part of the map surface to be drawn again.
+ * Overlapping areas are joined so no tile is drawn twice.
+ * @param area Area in surface coordinates.
+ */
+void Map::invalidateArea(const SDL_Rect &area)
+{
+	SDL_Rect rect = area;
+	clipRect(rect, getWidth(), getHeight());
+	if (rect.w == 0)
+	{
+		return;
+	}
+	for (size_t i = 0; i < _dirtyAreas.size();)
+	{
+		if (overlapRect(rect, _dirtyAreas[i]))
+		{
+			uniteRect(rect, _dirtyAreas[i]);
+			_dirtyAreas[i] = _dirtyAreas.back();
+			_dirtyAreas.pop_back();
+			// the joined area can reach the ones already checked
+			i = 0;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	_dirtyAreas.push_back(rect);
+
+	// every area costs a walk over the visible tiles, past some count one bigger area is cheaper
+	if ((int)_dirtyAreas.size() > MAX_DIRTY_AREAS)
+	{
+		SDL_Rect all = {};
+		for (const SDL_Rect &dirty : _dirtyAreas)
+		{
+			uniteRect(all, dirty);
+		}
+		_dirtyAreas.assign(1, all);
+	}
+}
+
+/**
+ * Marks the area covered by the flying projectile, both where
+ * it was last drawn and where it is now, to be drawn again.
+ */
+void Map::invalidateProjectile()
+{
+	invalidateArea(_projectileArea);
+	invalidateArea(getProjectileArea());
+}
+
+/**
+ * Marks the area covered by the explosions, both where
+ * they were last drawn and where they are now, to be drawn again.
+ */
+void Map::invalidateExplosions()
+{
+	invalidateArea(_explosionArea);
+	invalidateArea(getExplosionArea());
+	// the projectile disappears once the explosions start
+	invalidateProjectile();
+}
+
+/**
+ * Marks the units whose sprites can have changed to be drawn again,
+ * both where they were last marked and where they are now.
+ * @param animated Did the animation frame change? Then every shown unit is marked.
+ * @param movingUnit Unit that is known to have changed, even if it covers the same area.
+ */
+void Map::invalidateUnits(bool animated, const BattleUnit *movingUnit)
+{
+	const std::vector<BattleUnit*> &units = *_save->getUnits();
+	_unitAreas.resize(units.size());
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		SDL_Rect area = getUnitArea(units[i]);
+		SDL_Rect &last = _unitAreas[i];
+		if (!sameRect(area, last) || units[i] == movingUnit || (animated && area.w != 0))
+		{
+			invalidateArea(last);
+			invalidateArea(area);
+			last = area;
+		}
 	}
 }
 
+/**
+ * Collects everything that affects the whole map view at once.
+ * @param terrain Is the terrain shown instead of the hidden movement message?
+ * @return Current state.
+ */
+MapDrawnState Map::getDrawnState(bool terrain) const
+{
+	MapDrawnState state = {};
+	state.cameraOffset = _camera->getMapOffset();
+	state.selectedUnit = _save->getSelectedUnit();
+	if (state.selectedUnit)
+	{
+		state.selectedUnitPosition = state.selectedUnit->getPosition();
+	}
+	state.projectile = _projectile;
+	state.terrainRevision = Tile::getTerrainRevision();
+	state.viewRevision = Tile::getViewRevision();
+	state.fadeShade = _fadeShade;
+	state.nvColor = _nvColor;
+	state.debugVisionMode = _debugVisionMode;
+	state.cursorType = _cursorType;
+	state.cursorSize = _cursorSize;
+	state.waypoints = (int)_waypoints.size();
+	state.side = _save->getSide();
+	state.terrain = terrain;
+	state.projectileInFOV = _projectileInFOV;
+	state.showAllLayers = _camera->getShowAllLayers();
+	state.showObstacles = _showObstacles;
+	state.altPressed = (SDL_GetModState() & KMOD_ALT) != 0;
+	state.mouseOverIcons = _save->getBattleState()->getMouseOverIcons();
+	state.pathPreviewed = _save->getPathfinding()->isPathPreviewed();
+	return state;
+}
+
+/**
+ * Gets the surface area the 3D cursor covers on a given tile column,
+ * from the bottom of the map up to the current view level.
+ * @param selectorX X position of the cursor on the map.
+ * @param selectorY Y position of the cursor on the map.
+ * @return Area in surface coordinates.
+ */
+SDL_Rect Map::getSelectorArea(int selectorX, int selectorY) const
+{
+	SDL_Rect area = {};
+	int width = std::max(_spriteWidth, _txtAccuracy->getWidth());
+	for (int z : { 0, _camera->getViewLevel() })
+	{
+		for (int y : { selectorY, selectorY + _cursorSize - 1 })
+		{
+			for (int x : { selectorX, selectorX + _cursorSize - 1 })
+			{
+				Position screenPosition;
+				_camera->convertMapToScreen(Position(x, y, z), &screenPosition);
+				screenPosition += _camera->getMapOffset();
+				SDL_Rect tile = { (Sint16)screenPosition.x, (Sint16)screenPosition.y, (Uint16)width, (Uint16)_spriteHeight };
+				uniteRect(area, tile);
+			}
+		}
+	}
+	return area;
+}
+
+/**
+ * Gets the surface area covered by the flying projectile and its shadow.
+ * @return Area in surface coordinates, empty if there is nothing to draw.
+ */
+SDL_Rect Map::getProjectileArea() const
+{
+	SDL_Rect area = {};
+	if (!_projectile || !_explosions.empty())
+	{
+		return area;
+	}
+
+	BattleItem *item = _projectile->getItem();
+	int part = item ? 1 : BULLET_SPRITES - 1;
+	for (int i = 0; i <= part; ++i)
+	{
+		int width = _spriteWidth, height = _spriteHeight, offsetX = 16, offsetY = 26;
+		if (!item)
+		{
+			Surface *frame = _projectileSet->getFrame(_projectile->getParticle(i));
+			if (!frame)
+			{
+				continue;
+			}
+			width = frame->getWidth();
+			height = frame->getHeight();
+			offsetX = width / 2;
+			offsetY = height / 2;
+		}
+
+		Position voxelPos = _projectile->getPosition(1 - i);
+		for (int shadow = 0; shadow < 2; ++shadow)
+		{
+			if (shadow)
+			{
+				voxelPos.z = _save->getTileEngine()->castedShade(voxelPos);
+			}
+			Position screenPosition;
+			_camera->convertVoxelToScreen(voxelPos, &screenPosition);
+			SDL_Rect sprite = { (Sint16)(screenPosition.x - offsetX), (Sint16)(screenPosition.y - offsetY), (Uint16)width, (Uint16)height };
+			uniteRect(area, sprite);
+		}
+	}
+	return area;
+}
+
+/**
+ * Gets the surface area a tile sprite can cover, from its floor
+ * up to the top of a tall object standing on it.
+ * @param pos Position of the tile on the map.
+ * @return Area in surface coordinates.
+ */
+SDL_Rect Map::getTileArea(Position pos) const
+{
+	Position screenPosition;
+	_camera->convertMapToScreen(pos, &screenPosition);
+	screenPosition += _camera->getMapOffset();
+	SDL_Rect area = { (Sint16)screenPosition.x, (Sint16)(screenPosition.y - _spriteHeight), (Uint16)_spriteWidth, (Uint16)(_spriteHeight * 2) };
+	return area;
+}
+
+/**
+ * Gets the surface area covered by a unit, including both tiles
+ * it is walking between and the marker shown above it.
+ * @param unit Pointer to the unit.
+ * @return Area in surface coordinates, empty if the unit isn't drawn.
+ */
+SDL_Rect Map::getUnitArea(const BattleUnit *unit) const
+{
+	SDL_Rect area = {};
+	if (unit->getPosition() == TileEngine::invalid || unit->isOut() || !(unit->getVisible() || _save->getDebugMode()))
+	{
+		return area;
+	}
+
+	int size = unit->getArmor()->getSize();
+	bool moving = unit->getStatus() == STATUS_WALKING || unit->getStatus() == STATUS_FLYING;
+	for (const Position &pos : { unit->getPosition(), unit->getDestination(), unit->getLastPosition() })
+	{
+		for (int x = 0; x < size; ++x)
+		{
+			for (int y = 0; y < size; ++y)
+			{
+				uniteRect(area, getTileArea(pos + Position(x, y, 0)));
+			}
+		}
+		if (!moving)
+		{
+			break;
+		}
+	}
+	// the sprite is offset by half a tile while walking and the marker floats above it
+	area.x -= _spriteWidth / 2;
+	area.y -= _spriteHeight / 2;
+	area.w += _spriteWidth;
+	area.h += _spriteHeight / 2;
+	return area;
+}
+
+/**
+ * Gets the surface area covered by the explosion sprites.
+ * @return Area in surface coordinates, empty if there is nothing to draw.
+ */
+SDL_Rect Map::getExplosionArea() const
+{
+	SDL_Rect area = {};
+	for (const Explosion *explosion : _explosions)
+	{
+		Surface *frame;
+		int offsetX = 15, offsetY = 15;
+		if (explosion->isBig())
+		{
+			if (explosion->getCurrentFrame() < 0)
+			{
+				continue;
+			}
+			frame = _game->getMod()->getSurfaceSet("X1.PCK")->getFrame(explosion->getCurrentFrame());
+			if (frame)
+			{
+				offsetX = frame->getWidth() / 2;
+				offsetY = frame->getHeight() / 2;
+			}
+		}
+		else if (explosion->isHit())
+		{
+			frame = _game->getMod()->getSurfaceSet("HIT.PCK")->getFrame(explosion->getCurrentFrame());
+			offsetY = 25;
+		}
+		else
+		{
+			frame = _game->getMod()->getSurfaceSet("SMOKE.PCK")->getFrame(explosion->getCurrentFrame());
+		}
+		if (!frame)
+		{
+			continue;
+		}
+
+		Position screenPosition;
+		_camera->convertVoxelToScreen(explosion->getPosition(), &screenPosition);
+		SDL_Rect sprite = { (Sint16)(screenPosition.x - offsetX), (Sint16)(screenPosition.y - offsetY), (Uint16)frame->getWidth(), (Uint16)frame->getHeight() };
+		uniteRect(area, sprite);
+	}
+	return area;
+}
+
 /**
  * Replaces a certain amount of colors in the surface's palette.
  * @param colors Pointer to the set of colors.
@@ -642,8 +1078,9 @@ void Map::drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Posit
  * Draw the terrain.
  * Keep this function as optimised as possible. It's big to minimise overhead of function calls.
  * @param surface The surface to draw on.
+ * @param area Part of the surface to draw, grows to the whole surface if the camera has to move.
  */
-void Map::drawTerrain(Surface *surface)
+void Map::drawTerrain(Surface *surface, SDL_Rect &area)
 {
 	_isAltPressed = (SDL_GetModState() & KMOD_ALT) != 0;
 	int frameNumber = 0;
@@ -657,8 +1094,8 @@ void Map::drawTerrain(Surface *surface)
 	int dummy;
 	BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit();
 	int tileShade, tileColor, obstacleShade;
-	UnitSprite unitSprite(surface, _game->getMod(), _animFrame, _save->getDepth() != 0);
-	ItemSprite itemSprite(surface, _game->getMod(), _animFrame);
+	UnitSprite unitSprite(surface, _game->getMod(), _animFrame, _save->getDepth() != 0, _spriteCache);
+	ItemSprite itemSprite(surface, _game->getMod(), _animFrame, _spriteCache);
 
 	const int halfAnimFrame = (_animFrame / 2) % 4;
 	const int halfAnimFrameRest = (_animFrame % 2);
@@ -765,6 +1202,21 @@ void Map::drawTerrain(Surface *surface)
 		}
 	}
 
+	// following the projectile moved the camera, the whole view has to be drawn
+	bool wholeSurface = area.w == surface->getWidth() && area.h == surface->getHeight();
+	if (!wholeSurface && _camera->getMapOffset() != _drawnState.cameraOffset)
+	{
+		area = SDL_Rect{ 0, 0, (Uint16)surface->getWidth(), (Uint16)surface->getHeight() };
+		wholeSurface = true;
+		ShaderDraw<helper::Fill>(
+			ShaderSurface(surface),
+			ShaderScalar<Uint8>(Palette::blockOffset(0) + _bgColor)
+		);
+	}
+	// tiles drawn only in part still have to include everything that can spill over into the area
+	const int marginX = wholeSurface ? _spriteWidth : 2 * _spriteWidth;
+	const int marginY = wholeSurface ? _spriteHeight : 2 * _spriteHeight;
+
 	// get corner map coordinates to give rough boundaries in which tiles to redraw are
 	_camera->convertScreenToMap(0, 0, &beginX, &dummy);
 	_camera->convertScreenToMap(surface->getWidth(), 0, &dummy, &beginY);
@@ -812,8 +1264,8 @@ void Map::drawTerrain(Surface *surface)
 				screenPosition += cameraPos;
 
 				// only render cells that are inside the surface
-				if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+				if (screenPosition.x > area.x - marginX && screenPosition.x < area.x + area.w + marginX &&
+					screenPosition.y > area.y - marginY && screenPosition.y < area.y + area.h + marginY )
 				{
 					auto isUnitMovingNearby = movingUnit && positionInRangeXY(movingUnitPosition, mapPosition, 2);
 
@@ -1142,7 +1594,7 @@ void Map::drawTerrain(Surface *surface)
 										dest = transparetOffsets[dest];
 									}
 								},
-								ShaderSurface(this),
+								ShaderSurface(surface),
 								ShaderMove(pixelMask, vaporX, vaporY)
 							);
 						}
@@ -1476,8 +1928,8 @@ void Map::drawTerrain(Surface *surface)
 					screenPosition += _camera->getMapOffset();
 
 					// only render cells that are inside the surface
-					if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+					if (screenPosition.x > area.x - marginX && screenPosition.x < area.x + area.w + marginX &&
+						screenPosition.y > area.y - marginY && screenPosition.y < area.y + area.h + marginY )
 					{
 						tile = _save->getTile(mapPosition);
 						if (!tile || !tile->isDiscovered(O_FLOOR) || tile->getPreview() == -1)
@@ -1770,15 +2222,17 @@ void Map::setSelectorPosition(int mx, int my)
 
 	if (oldX != _selectorX || oldY != _selectorY)
 	{
-		_redraw = true;
+		// only the cursor moved, redraw the tiles under its old and new place
+		invalidateArea(getSelectorArea(oldX, oldY));
+		invalidateArea(getSelectorArea(_selectorX, _selectorY));
 	}
 }
 
 /**
  * Handles animating tiles. 8 Frames per animation.
- * @param redraw Redraw the battlescape?
+ * Everything drawn differently on the new frame is marked to be drawn again.
  */
-void Map::animate(bool redraw)
+void Map::animate()
 {
 	_save->nextAnimFrame();
 	_animFrame = _save->getAnimFrame();
@@ -1797,12 +2251,34 @@ void Map::animate(bool redraw)
 	}
 
 	// animate tiles
+	int viewLevel = _camera->getViewLevel();
+	bool showAllLayers = _camera->getShowAllLayers();
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		_save->getTile(i)->animate();
+		Tile *tile = _save->getTile(i);
+		bool animated = tile->animate();
+		if (tile->getPosition().z > viewLevel && !showAllLayers)
+		{
+			continue;
+		}
+		if (animated || tile->getFire() || tile->getSmoke() || isFloorSpriteAnimated(tile->getTopItem()))
+		{
+			invalidateArea(getTileArea(tile->getPosition()));
+		}
 	}
 
 	// animate vapor
+	const auto cameraPos = _camera->getMapOffset();
+	auto vaporArea = [&](const std::vector<Particle> &particles)
+	{
+		SDL_Rect area = {};
+		for (const auto& p : particles)
+		{
+			SDL_Rect pixels = { (Sint16)(p.getX() + cameraPos.x), (Sint16)(p.getY() + cameraPos.y), 2, 2 };
+			uniteRect(area, pixels);
+		}
+		return area;
+	};
 	for (auto& tilePar : _vaporParticles)
 	{
 		if (tilePar.empty())
@@ -1810,6 +2286,7 @@ void Map::animate(bool redraw)
 			continue;
 		}
 
+		invalidateArea(vaporArea(tilePar));
 		auto left = Collections::removeIf(
 			tilePar,
 			[](Particle& p)
@@ -1822,6 +2299,7 @@ void Map::animate(bool redraw)
 			//clean all allocated memory, after every particle expire.
 			Collections::removeAll(tilePar);
 		}
+		invalidateArea(vaporArea(tilePar));
 	}
 
 	// animate certain units (large flying units have a propulsion animation)
@@ -1856,7 +2334,27 @@ void Map::animate(bool redraw)
 		}
 	}
 
-	if (redraw) _redraw = true;
+	invalidateUnits(true);
+
+	// the cursor and the motion scanner arrows blink
+	if (_cursorType != CT_NONE)
+	{
+		invalidateArea(getSelectorArea(_selectorX, _selectorY));
+	}
+	if (_isAltPressed && _save->getSide() == FACTION_PLAYER)
+	{
+		for (const BattleUnit *unit : *_save->getUnits())
+		{
+			if (unit->getScannedTurn() == _save->getTurn() && unit->getFaction() != FACTION_PLAYER && !unit->isOut())
+			{
+				invalidateArea(getTileArea(Position(unit->getPosition().x, unit->getPosition().y, viewLevel)));
+			}
+		}
+	}
+	if (_showObstacles)
+	{
+		_redraw = true;
+	}
 }
 
 /**
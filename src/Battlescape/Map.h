@@ -40,6 +40,7 @@ class Timer;
 class Text;
 class Tile;
 class UnitSprite;
+class ScriptBlitCache;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 enum TilePart : int;
@@ -54,6 +55,33 @@ struct UnitWalkingOffset
 	int TerrainLevelOffset;
 };
 
+/**
+ * Everything that affects the whole map surface at once.
+ * Only while it stays the same can a part of the surface be redrawn on its own.
+ */
+struct MapDrawnState
+{
+	Position cameraOffset, selectedUnitPosition;
+	const BattleUnit *selectedUnit;
+	const Projectile *projectile;
+	Uint32 terrainRevision, viewRevision;
+	int fadeShade, nvColor, debugVisionMode, cursorType, cursorSize, waypoints, side;
+	bool terrain, projectileInFOV, showAllLayers, showObstacles, altPressed, mouseOverIcons, pathPreviewed;
+
+	bool operator==(const MapDrawnState &other) const
+	{
+		return cameraOffset == other.cameraOffset && selectedUnitPosition == other.selectedUnitPosition &&
+			selectedUnit == other.selectedUnit && projectile == other.projectile &&
+			terrainRevision == other.terrainRevision && viewRevision == other.viewRevision &&
+			fadeShade == other.fadeShade && nvColor == other.nvColor &&
+			debugVisionMode == other.debugVisionMode && cursorType == other.cursorType && cursorSize == other.cursorSize &&
+			waypoints == other.waypoints && side == other.side &&
+			terrain == other.terrain && projectileInFOV == other.projectileInFOV && showAllLayers == other.showAllLayers &&
+			showObstacles == other.showObstacles && altPressed == other.altPressed && mouseOverIcons == other.mouseOverIcons &&
+			pathPreviewed == other.pathPreviewed;
+	}
+};
+
 /**
  * Interactive map of the battlescape.
  */
@@ -65,6 +93,7 @@ private:
 	static const int NIGHT_VISION_SHADE = 4;
 	static const int NIGHT_VISION_MAX_SHADE = 8;
 	static const int BULLET_SPRITES = 35;
+	static const int MAX_DIRTY_AREAS = 8;
 	Timer *_scrollMouseTimer, *_scrollKeyTimer, *_obstacleTimer;
 	Timer *_fadeTimer;
 	int _fadeShade;
@@ -101,9 +130,20 @@ private:
 	PathPreview _previewSetting;
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
+	MapDrawnState _drawnState;
+	std::vector<SDL_Rect> _dirtyAreas, _unitAreas;
+	SDL_Rect _projectileArea, _explosionArea;
+	Surface *_redrawSurface;
+	ScriptBlitCache *_spriteCache;
 
 	void drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
-	void drawTerrain(Surface *surface);
+	void drawTerrain(Surface *surface, SDL_Rect &area);
+	MapDrawnState getDrawnState(bool terrain) const;
+	SDL_Rect getTileArea(Position pos) const;
+	SDL_Rect getUnitArea(const BattleUnit *unit) const;
+	SDL_Rect getSelectorArea(int selectorX, int selectorY) const;
+	SDL_Rect getProjectileArea() const;
+	SDL_Rect getExplosionArea() const;
 	int getTerrainLevel(const Position& pos, int size) const;
 	int getWallShade(TilePart part, Tile* tileFrot);
 	int _iconHeight, _iconWidth, _messageColor;
@@ -120,6 +160,16 @@ public:
 	void think() override;
 	/// Draws the surface.
 	void draw() override;
+	/// Blits the surface, redrawing the dirty area first.
+	void blit(SDL_Surface *surface) override;
+	/// Marks a part of the map surface for redraw.
+	void invalidateArea(const SDL_Rect &area);
+	/// Marks the path of the flying projectile for redraw.
+	void invalidateProjectile();
+	/// Marks the explosion sprites for redraw.
+	void invalidateExplosions();
+	/// Marks the units whose sprites can have changed for redraw.
+	void invalidateUnits(bool animated, const BattleUnit *movingUnit = nullptr);
 	/// Sets the palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256) override;
 	/// Special handling for mouse press.
@@ -133,7 +183,7 @@ public:
 	/// Special handling for key releases.
 	void keyboardRelease(Action *action, State *state) override;
 	/// Rotates the tile frames 0-7
-	void animate(bool redraw);
+	void animate();
 	/// Sets the battlescape selector position relative to mouse position.
 	void setSelectorPosition(int mx, int my);
 	/// Gets the currently selected position.
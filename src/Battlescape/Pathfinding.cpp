@@ -18,6 +18,7 @@
  */
 #include <list>
 #include <algorithm>
+#include <climits>
 #include "Pathfinding.h"
 #include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -25,6 +26,7 @@
 #include "../Mod/Armor.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "BattlescapeGame.h"
 #include "TileEngine.h"
 
@@ -43,7 +45,7 @@ int Pathfinding::green = 4;
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _searchGeneration(0), _blockedGeneration(1), _blockedTerrainRevision(Tile::getTerrainRevision()), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _ignoreUnits(false), _terrainOnly(false), _movementType(MT_WALK)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -52,6 +54,7 @@ Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPr
 	{
 		_nodes.push_back(PathfindingNode(_save->getTileCoords(i)));
 	}
+	_blockedDirections.resize(_size * (MT_SINK + 1) * 2, 0);
 }
 
 /**
@@ -63,14 +66,283 @@ Pathfinding::~Pathfinding()
 	// Nothing more to do here.
 }
 
+/**
+ * Starts a new search. Instead of resetting every node of the map,
+ * nodes are reset the first time the search touches them.
+ */
+void Pathfinding::startSearch()
+{
+	_openSet.clear();
+	if (_searchGeneration == INT_MAX)
+	{
+		for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+		{
+			it->reset(0);
+		}
+		_searchGeneration = 0;
+	}
+	++_searchGeneration;
+}
+
 /**
  * Gets the Node on a given position on the map.
  * @param pos Position.
- * @return Pointer to node.
+ * @return Pointer to node, reset if the current search didn't use it yet.
  */
 PathfindingNode *Pathfinding::getNode(Position pos)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = &_nodes[_save->getTileIndex(pos)];
+	node->reset(_searchGeneration);
+	return node;
+}
+
+/**
+ * Gets the directions a unit can't leave a tile in because of walls, as
+ * isBlockedDirection would tell. The result only depends on the terrain,
+ * the movement type and whether this is a missile, so it is kept until
+ * any tile of the map changes and then rebuilt for the tiles that are used.
+ * @param startTile The tile to start from.
+ * @param missileTarget Target for a missile.
+ * @return Bit mask of blocked directions 0-7.
+ */
+int Pathfinding::getBlockedDirections(Tile *startTile, BattleUnit *missileTarget)
+{
+	if (_blockedTerrainRevision != Tile::getTerrainRevision())
+	{
+		_blockedTerrainRevision = Tile::getTerrainRevision();
+		if (++_blockedGeneration == (1 << 24))
+		{
+			std::fill(_blockedDirections.begin(), _blockedDirections.end(), 0);
+			_blockedGeneration = 1;
+		}
+	}
+	Uint32 &entry = _blockedDirections[(_save->getTileIndex(startTile->getPosition()) * (MT_SINK + 1) + _movementType) * 2 + (missileTarget != 0)];
+	if ((entry >> 8) != _blockedGeneration)
+	{
+		Uint32 blocked = 0;
+		for (int direction = 0; direction < 8; ++direction)
+		{
+			if (isBlockedDirection(startTile, direction, missileTarget))
+			{
+				blocked |= 1 << direction;
+			}
+		}
+		entry = (_blockedGeneration << 8) | blocked;
+	}
+	return entry & 0xFF;
+}
+
+namespace
+{
+
+/**
+ * Finds the representative of a set, halving the path on the way.
+ * @param parent Parent of each element.
+ * @param i Element to look up.
+ * @return Representative element.
+ */
+int findRegionRoot(int *parent, int i)
+{
+	while (parent[i] != i)
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/**
+ * Joins two sets, keeping the lower element as representative.
+ * @param parent Parent of each element.
+ * @param a First element.
+ * @param b Second element.
+ */
+void joinRegions(int *parent, int a, int b)
+{
+	a = findRegionRoot(parent, a);
+	b = findRegionRoot(parent, b);
+	if (a < b)
+	{
+		parent[b] = a;
+	}
+	else if (b < a)
+	{
+		parent[a] = b;
+	}
+}
+
+}
+
+/**
+ * Gets the region map chunk a position is in. Chunks are square blocks of
+ * tiles on a single level, laid out like the base module map.
+ * @param pos Map position.
+ * @return Chunk index.
+ */
+int Pathfinding::getRegionChunk(Position pos) const
+{
+	const int chunksX = (_save->getMapSizeX() + REGION_CHUNK_SIZE - 1) / REGION_CHUNK_SIZE;
+	const int chunksY = (_save->getMapSizeY() + REGION_CHUNK_SIZE - 1) / REGION_CHUNK_SIZE;
+	return (pos.z * chunksY + pos.y / REGION_CHUNK_SIZE) * chunksX + pos.x / REGION_CHUNK_SIZE;
+}
+
+/**
+ * Gets the region map for the size and movement type of the current unit.
+ * Tiles of a chunk are grouped into regions by the steps that stay inside
+ * the chunk, and the steps leaving it are kept as portals joining regions of
+ * different chunks. When the terrain changes only the chunks around the
+ * changed tiles are grouped again. Units, fire and smoke don't take part,
+ * so the map only has to follow the terrain; the path search itself still
+ * pays for them.
+ * @return Region map, up to date with the current terrain.
+ */
+Pathfinding::RegionMap &Pathfinding::getRegionMap()
+{
+	const int size = _unit->getArmor()->getSize();
+	RegionMap *map = 0;
+	for (std::vector<RegionMap>::iterator i = _regionMaps.begin(); i != _regionMaps.end(); ++i)
+	{
+		if (i->movementType == _movementType && i->size == size)
+		{
+			map = &(*i);
+			break;
+		}
+	}
+	if (map == 0)
+	{
+		_regionMaps.push_back(RegionMap());
+		map = &_regionMaps.back();
+		map->movementType = _movementType;
+		map->size = size;
+		map->terrainRevision = 0;
+	}
+	else if (map->terrainRevision == Tile::getTerrainRevision())
+	{
+		return *map;
+	}
+
+	const int mapX = _save->getMapSizeX();
+	const int mapY = _save->getMapSizeY();
+	const int mapZ = _save->getMapSizeZ();
+	const int chunksX = (mapX + REGION_CHUNK_SIZE - 1) / REGION_CHUNK_SIZE;
+	const int chunksY = (mapY + REGION_CHUNK_SIZE - 1) / REGION_CHUNK_SIZE;
+	const int chunks = chunksX * chunksY * mapZ;
+
+	std::vector<bool> dirty(chunks, map->tileRegion.empty());
+	if (map->tileRegion.empty())
+	{
+		map->tileRegion.resize(_size);
+		map->chunkPortals.resize(chunks);
+		map->regionParent.resize(chunks * REGION_CHUNK_TILES);
+	}
+	else
+	{
+		// a step reads the tiles around both ends and the levels above and below
+		for (int i = 0; i < _size; ++i)
+		{
+			if (_save->getTile(i)->getTerrainChangedAt() <= map->terrainRevision)
+			{
+				continue;
+			}
+			Position pos = _save->getTileCoords(i);
+			for (int z = std::max(pos.z - 1, 0); z <= std::min(pos.z + 1, mapZ - 1); ++z)
+			{
+				for (int y = std::max(pos.y - 3, 0) / REGION_CHUNK_SIZE; y <= std::min(pos.y + 3, mapY - 1) / REGION_CHUNK_SIZE; ++y)
+				{
+					for (int x = std::max(pos.x - 3, 0) / REGION_CHUNK_SIZE; x <= std::min(pos.x + 3, mapX - 1) / REGION_CHUNK_SIZE; ++x)
+					{
+						dirty[(z * chunksY + y) * chunksX + x] = true;
+					}
+				}
+			}
+		}
+	}
+	map->terrainRevision = Tile::getTerrainRevision();
+
+	const bool strafeMove = _strafeMove;
+	_strafeMove = false;
+	_ignoreUnits = true;
+	_terrainOnly = true;
+	for (int chunk = 0; chunk < chunks; ++chunk)
+	{
+		if (!dirty[chunk])
+		{
+			continue;
+		}
+		const int x0 = (chunk % chunksX) * REGION_CHUNK_SIZE;
+		const int y0 = (chunk / chunksX % chunksY) * REGION_CHUNK_SIZE;
+		const int z = chunk / (chunksX * chunksY);
+		const int x1 = std::min(x0 + REGION_CHUNK_SIZE, mapX);
+		const int y1 = std::min(y0 + REGION_CHUNK_SIZE, mapY);
+		std::vector<std::pair<int, int> > &portals = map->chunkPortals[chunk];
+		portals.clear();
+		int parent[REGION_CHUNK_TILES];
+		for (int i = 0; i < REGION_CHUNK_TILES; ++i)
+		{
+			parent[i] = i;
+		}
+		for (int y = y0; y < y1; ++y)
+		{
+			for (int x = x0; x < x1; ++x)
+			{
+				Position pos(x, y, z);
+				for (int direction = 0; direction < dir_max; ++direction)
+				{
+					Position nextPos;
+					if (getTUCost(pos, direction, &nextPos, _unit, 0, false) >= 255)
+						continue;
+					if (nextPos.z == z && nextPos.x >= x0 && nextPos.x < x1 && nextPos.y >= y0 && nextPos.y < y1)
+					{
+						joinRegions(parent, (y - y0) * REGION_CHUNK_SIZE + x - x0, (nextPos.y - y0) * REGION_CHUNK_SIZE + nextPos.x - x0);
+					}
+					else
+					{
+						portals.push_back(std::make_pair(_save->getTileIndex(pos), _save->getTileIndex(nextPos)));
+					}
+				}
+			}
+		}
+		for (int y = y0; y < y1; ++y)
+		{
+			for (int x = x0; x < x1; ++x)
+			{
+				map->tileRegion[_save->getTileIndex(Position(x, y, z))] = chunk * REGION_CHUNK_TILES + findRegionRoot(parent, (y - y0) * REGION_CHUNK_SIZE + x - x0);
+			}
+		}
+	}
+	_ignoreUnits = false;
+	_terrainOnly = false;
+	_strafeMove = strafeMove;
+
+	// the portals are few, so joining the regions again is cheap
+	int *regionParent = &map->regionParent[0];
+	for (int i = 0; i < chunks * REGION_CHUNK_TILES; ++i)
+	{
+		regionParent[i] = i;
+	}
+	for (std::vector<std::vector<std::pair<int, int> > >::const_iterator i = map->chunkPortals.begin(); i != map->chunkPortals.end(); ++i)
+	{
+		for (std::vector<std::pair<int, int> >::const_iterator j = i->begin(); j != i->end(); ++j)
+		{
+			joinRegions(regionParent, map->tileRegion[j->first], map->tileRegion[j->second]);
+		}
+	}
+	return *map;
+}
+
+/**
+ * Checks whether the terrain connects two positions for the current unit.
+ * Steps are taken as going both ways and units are ignored, so a negative
+ * answer means no path exists, while a positive one still needs a search.
+ * @param origin The position to start from.
+ * @param target The position we want to reach.
+ * @return False if the positions are not connected.
+ */
+bool Pathfinding::isRegionConnected(Position origin, Position target)
+{
+	RegionMap &map = getRegionMap();
+	int *regionParent = &map.regionParent[0];
+	return findRegionRoot(regionParent, map.tileRegion[_save->getTileIndex(origin)]) == findRegionRoot(regionParent, map.tileRegion[_save->getTileIndex(target)]);
 }
 
 /**
@@ -82,6 +354,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	Profiler::Scope profile(PROF_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -135,6 +408,12 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 	_strafeMove = Options::strafe && (SDL_GetModState() & KMOD_CTRL) != 0 && (startPosition.z == endPosition.z) &&
 							(abs(startPosition.x - endPosition.x) <= 1) && (abs(startPosition.y - endPosition.y) <= 1);
 
+	// far away targets the terrain doesn't lead to at all would make A* search everything reachable
+	if (target == 0 && getRegionChunk(startPosition) != getRegionChunk(endPosition) && !isRegionConnected(startPosition, endPosition))
+	{
+		return;
+	}
+
 	// look for a possible fast and accurate bresenham path and skip A*
 	if (startPosition.z == endPosition.z && bresenhamPath(startPosition,endPosition, target, sneak))
 	{
@@ -165,14 +444,12 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  */
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	startSearch();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
@@ -278,7 +555,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		if (direction < DIR_UP && startTile[i]->getTerrainLevel() > - 16)
 		{
 			// check if we can go this way
-			if (isBlockedDirection(startTile[i], direction, target))
+			if (getBlockedDirections(startTile[i], target) & (1 << direction))
 				return 255;
 			if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 				return 255;
@@ -293,7 +570,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		{
 			maskOfPartsGoingDown |= maskCurrentPart;
 		}
-		else if (!missile && _movementType == MT_FLY)
+		else if (!missile && _movementType == MT_FLY && !_ignoreUnits)
 		{
 			// 2 or more voxels poking into this tile = no go
 			auto overlaping = destinationTile[i]->getOverlappingUnit(_save, TUO_IGNORE_SMALL);
@@ -369,7 +646,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		if (direction < DIR_UP && sameLevel)
 		{
 			// check if we can go this way
-			if (isBlockedDirection(startTile[i], direction, target))
+			if (getBlockedDirections(startTile[i], target) & (1 << direction))
 				return 255;
 			if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 				return 255;
@@ -393,7 +670,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 			if (direction < DIR_UP)
 			{
 				// check if we can go this way
-				if (isBlockedDirection(startTile[i], direction, target))
+				if (getBlockedDirections(startTile[i], target) & (1 << direction))
 					return 255;
 				if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 					return 255;
@@ -441,13 +718,14 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		}
 
 		cost += wallcost;
-		if (_unit->getFaction() != FACTION_PLAYER &&
+		if (!_terrainOnly &&
+			_unit->getFaction() != FACTION_PLAYER &&
 			_unit->getSpecialAbility() < SPECAB_BURNFLOOR &&
 			destinationTile[i]->getFire() > 0)
 			cost += 32; // try to find a better path, but don't exclude this path entirely.
 
 		// TFTD thing: underwater tiles on fire or filled with smoke cost 2 TUs more for whatever reason.
-		if (_save->getDepth() > 0 && (destinationTile[i]->getFire() > 0 || destinationTile[i]->getSmoke() > 0))
+		if (!_terrainOnly && _save->getDepth() > 0 && (destinationTile[i]->getFire() > 0 || destinationTile[i]->getSmoke() > 0))
 		{
 			cost += 2;
 		}
@@ -475,14 +753,14 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		Tile *originTile = _save->getTile(*endPosition + Position(1,1,0));
 		Tile *finalTile = _save->getTile(*endPosition);
 		int tmpDirection = 7;
-		if (isBlockedDirection(originTile, tmpDirection, target))
+		if (getBlockedDirections(originTile, target) & (1 << tmpDirection))
 			return 255;
 		if (!fellDown && abs(originTile->getTerrainLevel() - finalTile->getTerrainLevel()) > 10)
 			return 255;
 		originTile = _save->getTile(*endPosition + Position(1,0,0));
 		finalTile = _save->getTile(*endPosition + Position(0,1,0));
 		tmpDirection = 5;
-		if (isBlockedDirection(originTile, tmpDirection, target))
+		if (getBlockedDirections(originTile, target) & (1 << tmpDirection))
 			return 255;
 		if (!fellDown && abs(originTile->getTerrainLevel() - finalTile->getTerrainLevel()) > 10)
 			return 255;
@@ -599,7 +877,7 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 			tileNorth->getMapData(O_OBJECT)->getBigWall() == BIGWALLEASTANDSOUTH))
 			return true; // blocking part
 	}
-	if (part == O_FLOOR)
+	if (part == O_FLOOR && !_ignoreUnits)
 	{
 		if (tile->getUnit())
 		{
@@ -1146,16 +1424,14 @@ bool Pathfinding::bresenhamPath(Position origin, Position target, BattleUnit *ta
  */
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleActionCost &cost)
 {
+	Profiler::Scope profile(PROF_PATHFINDING);
 	const Position start = unit->getPosition();
 	int tuMax = unit->getTimeUnits() - cost.Time;
 	int energyMax = unit->getEnergy() - cost.Energy;
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
+	startSearch();
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
 	std::vector<PathfindingNode*> reachable;
 	while (!unvisited.empty())
@@ -20,6 +20,7 @@
 #include <vector>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Mod/MapData.h"
 
 namespace OpenXcom
@@ -40,20 +41,57 @@ private:
 	constexpr static int dir_x[dir_max] = {  0, +1, +1, +1,  0, -1, -1, -1,  0,  0};
 	constexpr static int dir_y[dir_max] = { -1, -1,  0, +1, +1, +1,  0, -1,  0,  0};
 	constexpr static int dir_z[dir_max] = {  0,  0,  0,  0,  0,  0,  0,  0, +1, -1};
+	/// Width of the square chunks of the region map, same as the base module blocks.
+	constexpr static int REGION_CHUNK_SIZE = 10;
+	constexpr static int REGION_CHUNK_TILES = REGION_CHUNK_SIZE * REGION_CHUNK_SIZE;
+
+	/// Coarse connectivity of the map for one movement type and unit size.
+	struct RegionMap
+	{
+		MovementType movementType;
+		int size;
+		/// Terrain revision the map was last brought up to date with.
+		Uint32 terrainRevision;
+		/// Region of each tile, as chunk index * REGION_CHUNK_TILES + local region.
+		std::vector<int> tileRegion;
+		/// Steps leading out of each chunk, as pairs of tile indices.
+		std::vector<std::vector<std::pair<int, int> > > chunkPortals;
+		/// Regions joined through the portals.
+		std::vector<int> regionParent;
+	};
 
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
+	PathfindingOpenSet _openSet;
+	int _searchGeneration;
+	/// Directions blocked by walls for each tile, movement type and missile flag, tagged with _blockedGeneration.
+	std::vector<Uint32> _blockedDirections;
+	Uint32 _blockedGeneration;
+	Uint32 _blockedTerrainRevision;
+	std::vector<RegionMap> _regionMaps;
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
 	bool _strafeMove;
 	int _totalTUCost;
 	bool _modifierUsed;
+	bool _ignoreUnits;
+	bool _terrainOnly;
 	MovementType _movementType;
+	/// Starts a new search, invalidating all nodes.
+	void startSearch();
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(Position pos);
+	/// Gets the directions blocked by walls when leaving a tile.
+	int getBlockedDirections(Tile *startTile, BattleUnit *missileTarget);
 	/// Determines whether a tile blocks a certain movementType.
 	bool isBlocked(Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion = -1) const;
+	/// Gets the index of the region map chunk of a position.
+	int getRegionChunk(Position pos) const;
+	/// Gets the region map for the current unit, updated to the current terrain.
+	RegionMap &getRegionMap();
+	/// Checks whether the terrain connects two positions at all.
+	bool isRegionConnected(Position origin, Position target);
 	/// Tries to find a straight line path between two positions.
 	bool bresenhamPath(Position origin, Position target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
 	/// Tries to find a path between two positions.
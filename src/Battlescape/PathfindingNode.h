@@ -23,7 +23,6 @@ namespace OpenXcom
 {
 
 class PathfindingOpenSet;
-struct OpenSetEntry;
 
 /**
  * A class that holds pathfinding info for a certain node on the map.
@@ -32,6 +31,8 @@ class PathfindingNode
 {
 private:
 	Position _pos;
+	/// Search that last touched this node, the other fields are stale when it doesn't match.
+	int _generation;
 	bool _checked;
 	int _tuCost;
 	PathfindingNode* _prevNode;
@@ -39,7 +40,7 @@ private:
 	/// Approximate cost to reach goal position.
 	int _tuGuess;
 	// Invasive field needed by PathfindingOpenSet
-	OpenSetEntry *_openentry;
+	int _openentry;
 	friend class PathfindingOpenSet;
 public:
 	/// Creates a new PathfindingNode class.
@@ -50,6 +51,15 @@ public:
 	Position getPosition() const;
 	/// Resets the node.
 	void reset();
+	/// Resets the node if it was last used by a different search.
+	void reset(int generation)
+	{
+		if (_generation != generation)
+		{
+			_generation = generation;
+			reset();
+		}
+	}
 	/// Is checked?
 	bool isChecked() const;
 	/// Marks the node as checked.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
 #include "PathfindingOpenSet.h"
 #include "PathfindingNode.h"
 
@@ -24,16 +25,13 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Removes all entries still in the set. Nodes are not touched,
+ * they get reset by the next search anyway.
  */
-PathfindingOpenSet::~PathfindingOpenSet()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty())
-	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
-	}
+	_heap.clear();
+	_lastId = 0;
 }
 
 /**
@@ -41,11 +39,10 @@ PathfindingOpenSet::~PathfindingOpenSet()
  */
 void PathfindingOpenSet::removeDiscarded()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	while (!_heap.empty() && _heap.front()._node->_openentry != _heap.front()._id)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		std::pop_heap(_heap.begin(), _heap.end(), EntryCompare());
+		_heap.pop_back();
 	}
 }
 
@@ -57,10 +54,9 @@ void PathfindingOpenSet::removeDiscarded()
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
+	PathfindingNode *nd = _heap.front()._node;
+	std::pop_heap(_heap.begin(), _heap.end(), EntryCompare());
+	_heap.pop_back();
 	nd->_openentry = 0;
 
 	// Discarded entries might be visible now.
@@ -76,13 +72,13 @@ PathfindingNode *PathfindingOpenSet::pop()
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	OpenSetEntry entry;
+	entry._node = node;
+	entry._cost = node->getTUCost(false) + node->getTUGuess();
+	entry._id = ++_lastId;
+	node->_openentry = entry._id;
+	_heap.push_back(entry);
+	std::push_heap(_heap.begin(), _heap.end(), EntryCompare());
 }
 
 
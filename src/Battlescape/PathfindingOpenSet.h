@@ -17,7 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -28,43 +28,49 @@ struct OpenSetEntry
 {
 	int _cost;
 	PathfindingNode *_node;
+	/// Matches the node's entry while this is its latest one.
+	int _id;
 };
 
 /**
- * Helper class to compare entries through pointers.
+ * Helper class to compare entries.
  */
 class EntryCompare
 {
 public:
 	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
+	 * Compares entries @a a and @a b.
+	 * @param a First entry.
+	 * @param b Second entry.
+	 * @return True if entry @a b must come before @a a.
 	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
+	bool operator()(const OpenSetEntry &a, const OpenSetEntry &b) const
 	{
-		return b->_cost < a->_cost;
+		return b._cost < a._cost;
 	}
 };
 
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * Entries live in one binary heap whose memory is kept between searches.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleans up the set and frees allocated memory.
-	~PathfindingOpenSet();
+	/// Creates an empty set.
+	PathfindingOpenSet() : _lastId(0) { }
+	/// Removes all entries, keeping the allocated memory.
+	void clear();
 	/// Gets the next node to check.
 	PathfindingNode *pop();
 	/// Adds a node to the set.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _heap.empty(); }
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
+	std::vector<OpenSetEntry> _heap;
+	int _lastId;
 
 	/// Removes reachable discarded entries.
 	void removeDiscarded();
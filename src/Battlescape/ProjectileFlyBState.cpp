@@ -846,6 +846,22 @@ void ProjectileFlyBState::think()
 	}
 }
 
+/**
+ * Marks the projectile path to be drawn again while it is the only thing moving.
+ */
+void ProjectileFlyBState::invalidateMap()
+{
+	Map *map = _parent->getMap();
+	if (map->getProjectile() && map->getExplosions()->empty())
+	{
+		map->invalidateProjectile();
+	}
+	else
+	{
+		map->invalidate();
+	}
+}
+
 /**
  * Flying projectiles cannot be cancelled,
  * but they can be "skipped".
@@ -54,6 +54,8 @@ public:
 	void cancel() override;
 	/// Runs state functionality every cycle.
 	void think() override;
+	/// Marks the parts of the map changed by the last think.
+	void invalidateMap() override;
 	/// Validates the throwing range.
 	static bool validThrowRange(BattleAction *action, Position origin, Tile *target, int depth);
 	/// Calculates the maximum throwing range.
@@ -45,6 +45,8 @@
 #include "Pathfinding.h"
 #include "../Engine/Game.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/WorkerPool.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -228,14 +230,17 @@ constexpr Position TileEngine::voxelTileCenter;
  * @param maxDarknessToSeeUnits Threshold of darkness for LoS calculation.
  */
 TileEngine::TileEngine(SavedBattleGame *save, Mod *mod) :
-	_save(save), _voxelData(mod->getVoxelData()), _inventorySlotGround(mod->getInventoryGround()), _personalLighting(true), _cacheTile(0), _cacheTileBelow(0),
+	_save(save), _voxelData(mod->getVoxelData()), _inventorySlotGround(mod->getInventoryGround()), _personalLighting(true),
 	_maxViewDistance(mod->getMaxViewDistance()), _maxViewDistanceSq(_maxViewDistance * _maxViewDistance),
 	_maxVoxelViewDistance(_maxViewDistance * 16), _maxDarknessToSeeUnits(mod->getMaxDarknessToSeeUnits()),
 	_maxStaticLightDistance(mod->getMaxStaticLightDistance()), _maxDynamicLightDistance(mod->getMaxDynamicLightDistance()),
 	_enhancedLighting(mod->getEnhancedLighting())
 {
 	_blockVisibility.resize(save->getMapSizeXYZ());
-	_cacheTilePos = invalid;
+	for (int i = 0; i < save->getMapSizeXYZ(); ++i)
+	{
+		save->getTile(i)->setVoxelShape(Tile::NOT_CALCULATED);
+	}
 }
 
 /**
@@ -410,6 +415,7 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	Profiler::Scope profile(PROF_LIGHTING);
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -744,6 +750,7 @@ inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
 */
 bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
 {
+	Profiler::Scope profile(PROF_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	bool useTurretDirection = false;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
@@ -754,14 +761,17 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 		return false;
 
 	Position posSelf = unit->getPosition();
-	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius))
+	bool fullCheck = setupEventVisibilitySector(posSelf, eventPos, eventRadius);
+	if (fullCheck)
 	{
 		//Asked to do a full check. Or the event is overlapping our tile. Better check everything.
 		unit->clearVisibleUnits();
 	}
+	std::vector<BattleUnit*> *units = _save->getUnits();
+	size_t selfIndex = std::find(units->begin(), units->end(), unit) - units->begin();
 
 	//Loop through all units specified and figure out which ones we can actually see.
-	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	for (std::vector<BattleUnit*>::iterator i = units->begin(); i != units->end(); ++i)
 	{
 		Position posOther = (*i)->getPosition();
 		if (!(*i)->isOut() && (unit->getId() != (*i)->getId()))
@@ -780,7 +790,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 							//Unit within arc, but not in view sector. If it just walked out we need to remove it.
 							unit->removeFromVisibleUnits((*i));
 						}
-						else if (visible(unit, _save->getTile(posToCheck))) // (distance is checked here)
+						else if (visibleIndexed(unit, selfIndex, *i, i - units->begin(), x * sizeOther + y, _save->getTile(posToCheck), fullCheck, eventPos, eventRadius)) // (distance is checked here)
 						{
 							//Unit (or part thereof) visible to one or more eyes of this unit.
 							if (unit->getFaction() == FACTION_PLAYER)
@@ -834,6 +844,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 */
 void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius)
 {
+	Profiler::Scope profile(PROF_FOV);
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
@@ -964,6 +975,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	Profiler::Scope profile(PROF_FOV);
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -1117,6 +1129,107 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 	return unitSeen;
 }
 
+/**
+ * Checks for an opposing unit on a tile, like visible(), but remembers the
+ * result for each pair of units. When an event only changed the map around
+ * eventPos, a pair whose lines of sight can't pass through that area and
+ * whose units didn't move, change height, side or armor, catch fire or get
+ * lit differently gets its last result back instead of a new trace.
+ * Observers with visibility scripts are always traced, as the scripts can
+ * read any state of both units.
+ * @param observer The watcher.
+ * @param observerIndex Index of the watcher in the unit list.
+ * @param target The unit being looked at.
+ * @param targetIndex Index of the target in the unit list.
+ * @param part Which tile of a large target is checked.
+ * @param tile The tile to check for.
+ * @param fullCheck Ignore remembered results.
+ * @param eventPos The centre of the event which necessitated the FOV update.
+ * @param eventRadius The radius of a circle able to fully encompass the event.
+ * @return True if visible.
+ */
+bool TileEngine::visibleIndexed(BattleUnit *observer, size_t observerIndex, BattleUnit *target, size_t targetIndex, int part, Tile *tile, bool fullCheck, Position eventPos, int eventRadius)
+{
+	size_t units = _save->getUnits()->size();
+	int targetSize = target->getArmor()->getSize();
+	if (observerIndex >= units || targetSize > 2 || observer->getArmor()->getScript<ModScript::VisibilityUnit>().haveAnyScript())
+	{
+		return visible(observer, tile);
+	}
+	if (_visibilityIndexUnits != units)
+	{
+		_visibilityIndex.assign(units * units, VisibilityRecord());
+		_visibilityIndexUnits = units;
+	}
+
+	Uint16 targetShade = 0;
+	for (int x = 0; x < targetSize; ++x)
+	{
+		for (int y = 0; y < targetSize; ++y)
+		{
+			Tile *t = _save->getTile(target->getPosition() + Position(x, y, 0));
+			targetShade = (targetShade << 4) | (t ? t->getShade() : 0);
+		}
+	}
+
+	VisibilityRecord &record = _visibilityIndex[observerIndex * units + targetIndex];
+	Uint8 bit = 1 << part;
+	if (record.observerPos != observer->getPosition() ||
+		record.targetPos != target->getPosition() ||
+		record.observerArmor != observer->getArmor() ||
+		record.targetArmor != target->getArmor() ||
+		record.observerFaction != observer->getFaction() ||
+		record.targetFaction != target->getFaction() ||
+		record.observerHeight != observer->getHeight() + observer->getFloatHeight() ||
+		record.targetHeight != target->getHeight() + target->getFloatHeight() ||
+		record.observerDayRange != observer->getMaxViewDistanceAtDay(nullptr) ||
+		record.observerDarkRange != observer->getMaxViewDistanceAtDark(nullptr) ||
+		record.targetShade != targetShade ||
+		record.targetFire != target->getFire())
+	{
+		record.observerPos = observer->getPosition();
+		record.targetPos = target->getPosition();
+		record.observerArmor = observer->getArmor();
+		record.targetArmor = target->getArmor();
+		record.observerFaction = observer->getFaction();
+		record.targetFaction = target->getFaction();
+		record.observerHeight = observer->getHeight() + observer->getFloatHeight();
+		record.targetHeight = target->getHeight() + target->getFloatHeight();
+		record.observerDayRange = observer->getMaxViewDistanceAtDay(nullptr);
+		record.observerDarkRange = observer->getMaxViewDistanceAtDark(nullptr);
+		record.targetShade = targetShade;
+		record.targetFire = target->getFire();
+		record.traced = 0;
+		record.seen = 0;
+	}
+	else if (!fullCheck && (record.traced & bit))
+	{
+		// every ray stays inside the box spanned by both units, plus a tile for the edges of the target
+		int observerSize = observer->getArmor()->getSize();
+		int minX = std::min(record.observerPos.x, record.targetPos.x) - 1;
+		int minY = std::min(record.observerPos.y, record.targetPos.y) - 1;
+		int maxX = std::max(record.observerPos.x + observerSize, record.targetPos.x + targetSize);
+		int maxY = std::max(record.observerPos.y + observerSize, record.targetPos.y + targetSize);
+		if (eventPos.x + eventRadius < minX || eventPos.x - eventRadius > maxX ||
+			eventPos.y + eventRadius < minY || eventPos.y - eventRadius > maxY)
+		{
+			return record.seen & bit;
+		}
+	}
+
+	bool result = visible(observer, tile);
+	record.traced |= bit;
+	if (result)
+	{
+		record.seen |= bit;
+	}
+	else
+	{
+		record.seen &= ~bit;
+	}
+	return result;
+}
+
 /**
  * Checks to see if a tile is visible through darkness, obstacles and smoke.
  * Note: psi vision, heat vision, camouflage/anti-camouflage and Y-scripts are intentionally removed.
@@ -1415,6 +1528,22 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
  * @return True if the unit can be targetted.
  */
 bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit)
+{
+	return canTargetUnit(_voxelCheckCache, originVoxel, tile, scanVoxel, excludeUnit, rememberObstacles, potentialUnit);
+}
+
+/**
+ * Checks for another unit available for targeting and what particular voxel.
+ * @param cache Tile cache of the voxel checks.
+ * @param originVoxel Voxel of trace origin (eye or gun's barrel).
+ * @param tile The tile to check for.
+ * @param scanVoxel is returned coordinate of hit.
+ * @param excludeUnit is self (not to hit self).
+ * @param rememberObstacles Remember obstacles for no LOF indicator?
+ * @param potentialUnit is a hypothetical unit to draw a virtual line of fire for AI. if left blank, this function behaves normally.
+ * @return True if the unit can be targetted.
+ */
+bool TileEngine::canTargetUnit(VoxelCheckCache &cache, Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit)
 {
 	Position targetVoxel = tile->getPosition().toVoxel() + Position(7, 8, 0);
 	std::vector<Position> _trajectory;
@@ -1476,7 +1605,7 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 			scanVoxel->x=targetVoxel.x + sliceTargets[j*2];
 			scanVoxel->y=targetVoxel.y + sliceTargets[j*2+1];
 			_trajectory.clear();
-			int test = calculateLineVoxel(*originVoxel, *scanVoxel, false, &_trajectory, excludeUnit);
+			int test = calculateLineVoxel(cache, *originVoxel, *scanVoxel, false, &_trajectory, excludeUnit, 0, false);
 			if (test == V_UNIT)
 			{
 				for (int x = 0; x <= targetSize; ++x)
@@ -1508,6 +1637,26 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 	return false;
 }
 
+/**
+ * Checks many units for targeting at once. Queries are split over the
+ * worker threads, each tracing against the map as it is now, so the
+ * results are the same as calling canTargetUnit for each one in order.
+ * Obstacles are not remembered.
+ * @param queries List of checks, results are stored in them.
+ */
+void TileEngine::canTargetUnits(std::vector<LineOfFireQuery> &queries)
+{
+	updateVoxelShapes();
+
+	std::vector<VoxelCheckCache> caches(queries.size());
+	auto job = [&](int i)
+	{
+		LineOfFireQuery &query = queries[i];
+		query.result = canTargetUnit(caches[i], &query.origin, query.tile, &query.scanVoxel, query.excludeUnit, false, query.potentialUnit);
+	};
+	WorkerPool::run((int)queries.size(), job);
+}
+
 /**
  * Checks for a tile part available for targeting and what particular voxel.
  * @param originVoxel Voxel of trace origin (gun's barrel).
@@ -1691,6 +1840,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	Profiler::Scope profile(PROF_FOV);
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -2535,6 +2685,7 @@ void TileEngine::hit(BattleActionAttack attack, Position center, int power, cons
  */
 void TileEngine::explode(BattleActionAttack attack, Position center, int power, const RuleDamageType *type, int maxRadius, bool rangeAtack)
 {
+	Profiler::Scope profile(PROF_EXPLOSIONS);
 	const Position centetTile = center.toTile();
 	int hitSide = 0;
 	int diagonalWall = 0;
@@ -2736,6 +2887,7 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
  */
 bool TileEngine::detonate(Tile* tile, int explosive)
 {
+	Profiler::Scope profile(PROF_EXPLOSIONS);
 	if (explosive == 0) return false; // no damage applied for this tile
 	bool objective = false;
 	Tile* tiles[9];
@@ -2855,6 +3007,7 @@ bool TileEngine::detonate(Tile* tile, int explosive)
  */
 Tile *TileEngine::checkForTerrainExplosions()
 {
+	Profiler::Scope profile(PROF_EXPLOSIONS);
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
 		if (_save->getTile(i)->getExplosive())
@@ -3575,6 +3728,23 @@ int TileEngine::calculateLineTile(Position origin, Position target, std::vector<
  * @return the objectnumber(0-3) or unit(4) or out of map (5) or -1(hit nothing).
  */
 VoxelType TileEngine::calculateLineVoxel(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, BattleUnit *excludeAllBut, bool onlyVisible)
+{
+	return calculateLineVoxel(_voxelCheckCache, origin, target, storeTrajectory, trajectory, excludeUnit, excludeAllBut, onlyVisible);
+}
+
+/**
+ * Calculates a line trajectory, using bresenham algorithm in 3D.
+ * @param cache Tile cache of the voxel checks.
+ * @param origin Origin in voxel.
+ * @param target Target in voxel.
+ * @param storeTrajectory True will store the whole trajectory - otherwise it just stores the last position.
+ * @param trajectory A vector of positions in which the trajectory is stored.
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllBut The only unit to be considered for ray hits.
+ * @param onlyVisible Skip invisible units? used in FPS view.
+ * @return the objectnumber(0-3) or unit(4) or out of map (5) or -1(hit nothing).
+ */
+VoxelType TileEngine::calculateLineVoxel(VoxelCheckCache &cache, Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, BattleUnit *excludeAllBut, bool onlyVisible)
 {
 	VoxelType result;
 	bool excludeAllUnits = false;
@@ -3591,7 +3761,7 @@ VoxelType TileEngine::calculateLineVoxel(Position origin, Position target, bool
 				trajectory->push_back(point);
 			}
 
-			result = voxelCheck(point, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
+			result = voxelCheck(cache, point, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
 			if (result != V_EMPTY)
 			{
 				if (trajectory)
@@ -3605,7 +3775,7 @@ VoxelType TileEngine::calculateLineVoxel(Position origin, Position target, bool
 		[&](Position point)
 		{
 			//check for xy diagonal intermediate voxel step
-			result = voxelCheck(point, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
+			result = voxelCheck(cache, point, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
 			if (result != V_EMPTY)
 			{
 				if (trajectory != 0)
@@ -3748,6 +3918,84 @@ bool TileEngine::isVoxelVisible(Position voxel)
 	return true;
 }
 
+/**
+ * Gets the bit-packed terrain voxels of a tile. Tiles built from the same
+ * parts (with open UFO doors treated as missing) share one shape.
+ * @param tile The tile.
+ * @return The voxel shape.
+ */
+const TileEngine::VoxelShape &TileEngine::getVoxelShape(Tile *tile)
+{
+	int index = tile->getVoxelShape();
+	if (index == Tile::NOT_CALCULATED)
+	{
+		std::array<const MapData*, O_MAX> parts;
+		for (int i = O_FLOOR; i < O_MAX; ++i)
+		{
+			TilePart tp = (TilePart)i;
+			parts[i] = tile->getMapData(tp);
+			if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+			{
+				parts[i] = nullptr;
+			}
+		}
+
+		auto it = _voxelShapeIndex.find(parts);
+		if (it != _voxelShapeIndex.end())
+		{
+			index = it->second;
+		}
+		else
+		{
+			VoxelShape shape = { };
+			for (int i = O_FLOOR; i < O_MAX; ++i)
+			{
+				if (parts[i] == nullptr)
+				{
+					continue;
+				}
+				for (int layer = 0; layer < Position::TileZ / 2; ++layer)
+				{
+					int idx = parts[i]->getLoftID(layer) * 16;
+					for (int y = 0; y < Position::TileXY; ++y)
+					{
+						shape.rows[layer][y] |= (Uint64)_voxelData->at(idx + y) << (16 * i);
+					}
+				}
+			}
+			index = (int)_voxelShapes.size();
+			_voxelShapes.push_back(shape);
+			_voxelShapeIndex[parts] = index;
+		}
+		tile->setVoxelShape(index);
+	}
+	return _voxelShapes[index];
+}
+
+/**
+ * Makes sure every tile has its voxel shape built, so that voxel
+ * checks only read the map and can run on several threads.
+ * Shapes are only dropped when terrain changes, so the map is
+ * not walked again until the terrain revision moves on.
+ */
+void TileEngine::updateVoxelShapes()
+{
+	if (_voxelShapesBuilt && _voxelShapesRevision == Tile::getTerrainRevision())
+	{
+		return;
+	}
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = _save->getTile(i);
+		if (!_voxelShapesBuilt || tile->getTerrainChangedAt() > _voxelShapesRevision)
+		{
+			getVoxelShape(tile);
+		}
+	}
+	_voxelShapesBuilt = true;
+	_voxelShapesRevision = Tile::getTerrainRevision();
+}
+
 /**
  * Checks if we hit a voxel.
  * @param voxel The voxel to check.
@@ -3758,6 +4006,21 @@ bool TileEngine::isVoxelVisible(Position voxel)
  * @return The objectnumber(0-3) or unit(4) or out of map (5) or -1 (hit nothing).
  */
 VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool excludeAllUnits, bool onlyVisible, BattleUnit *excludeAllBut)
+{
+	return voxelCheck(_voxelCheckCache, voxel, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
+}
+
+/**
+ * Checks if we hit a voxel.
+ * @param cache Last tile looked up, updated when the voxel is in a different tile.
+ * @param voxel The voxel to check.
+ * @param excludeUnit Don't do checks on this unit.
+ * @param excludeAllUnits Don't do checks on any unit.
+ * @param onlyVisible Whether to consider only visible units.
+ * @param excludeAllBut If set, the only unit to be considered for ray hits.
+ * @return The objectnumber(0-3) or unit(4) or out of map (5) or -1 (hit nothing).
+ */
+VoxelType TileEngine::voxelCheck(VoxelCheckCache &cache, Position voxel, BattleUnit *excludeUnit, bool excludeAllUnits, bool onlyVisible, BattleUnit *excludeAllBut)
 {
 	if (voxel.x < 0 || voxel.y < 0 || voxel.z < 0) //preliminary out of map
 	{
@@ -3765,10 +4028,10 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	}
 	Position pos = voxel.toTile();
 	Tile *tile, *tileBelow;
-	if (_cacheTilePos == pos)
+	if (cache.pos == pos)
 	{
-		tile = _cacheTile;
-		tileBelow = _cacheTileBelow;
+		tile = cache.tile;
+		tileBelow = cache.tileBelow;
 	}
 	else
 	{
@@ -3778,9 +4041,9 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 			return V_OUTOFBOUNDS; //not even cache
 		}
 		tileBelow = _save->getBelowTile(tile);
-		_cacheTilePos = pos;
-		_cacheTile = tile;
-		_cacheTileBelow = tileBelow;
+		cache.pos = pos;
+		cache.tile = tile;
+		cache.tileBelow = tileBelow;
  	}
 
 	if (tile->isVoid() && tile->getUnit() == 0 && (!tileBelow || tileBelow->getUnit() == 0))
@@ -3797,18 +4060,13 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	const VoxelShape &shape = getVoxelShape(tile);
+	Uint64 hit = (shape.rows[(voxel.z%24)/2][voxel.y%16] >> (15 - voxel.x%16)) & VoxelShape::partMask;
+	if (hit)
 	{
-		TilePart tp = (TilePart)i;
-		MapData *mp = tile->getMapData(tp);
-		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
-			continue;
-		if (mp != 0)
+		for (int i = V_FLOOR; i <= V_OBJECT; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			if (hit & ((Uint64)1 << (16 * i)))
 			{
 				return (VoxelType)i;
 			}
@@ -3859,9 +4117,7 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 
 void TileEngine::voxelCheckFlush()
 {
-	_cacheTilePos = invalid;
-	_cacheTile = 0;
-	_cacheTileBelow = 0;
+	_voxelCheckCache = VoxelCheckCache();
 }
 
 /**
@@ -4851,6 +5107,7 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
  */
 void TileEngine::recalculateFOV()
 {
+	Profiler::Scope profile(PROF_FOV);
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <array>
+#include <map>
 #include "Position.h"
 #include "BattlescapeGame.h"
 #include "../Mod/RuleItem.h"
@@ -32,6 +34,7 @@ class BattleUnit;
 class BattleItem;
 class Tile;
 class RuleSkill;
+class Armor;
 struct BattleAction;
 template<typename Tag, typename DataType> struct AreaSubset;
 
@@ -44,6 +47,25 @@ using MapSubset = AreaSubset<Position, Sint16>;
 enum BattleActionType : Uint8;
 enum LightLayers : Uint8;
 
+/**
+ * One line of fire check for TileEngine::canTargetUnits.
+ */
+struct LineOfFireQuery
+{
+	/// Voxel of trace origin (eye or gun's barrel).
+	Position origin;
+	/// The tile to check for.
+	Tile *tile = nullptr;
+	/// Unit not to hit (self).
+	BattleUnit *excludeUnit = nullptr;
+	/// Hypothetical unit standing on the tile, see TileEngine::canTargetUnit.
+	BattleUnit *potentialUnit = nullptr;
+	/// Returned coordinate of hit.
+	Position scanVoxel;
+	/// Returned result: can the unit be targeted?
+	bool result = false;
+};
+
 
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
@@ -79,6 +101,39 @@ private:
 		Uint8 smoke: 1;
 		Uint8 fire: 1;
 	};
+	/**
+	 * Helper class storing bit-packed voxel occupancy of all terrain parts of a tile.
+	 * Each row holds the LOFT rows of all four parts, part N in bits [16*N, 16*N+15].
+	 */
+	struct VoxelShape
+	{
+		/// Mask of the lowest bit of each part in a row.
+		static constexpr Uint64 partMask = 0x0001000100010001ULL;
+
+		Uint64 rows[Position::TileZ / 2][Position::TileXY];
+	};
+	/**
+	 * Helper class storing the last result of one unit looking at another,
+	 * together with everything outside of the map that result depends on.
+	 * Bits of `traced` and `seen` are the tiles of a large target unit.
+	 */
+	struct VisibilityRecord
+	{
+		Position observerPos = invalid;
+		Position targetPos = invalid;
+		const Armor *observerArmor = nullptr;
+		const Armor *targetArmor = nullptr;
+		UnitFaction observerFaction = {};
+		UnitFaction targetFaction = {};
+		Sint16 observerHeight = 0;
+		Sint16 targetHeight = 0;
+		Sint16 observerDayRange = 0;
+		Sint16 observerDarkRange = 0;
+		Uint16 targetShade = 0;
+		Uint8 targetFire = 0;
+		Uint8 traced = 0;
+		Uint8 seen = 0;
+	};
 	/**
 	 * Helper class storing reaction data.
 	 */
@@ -97,9 +152,20 @@ private:
 	RuleInventory *_inventorySlotGround;
 	constexpr static int heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 	bool _personalLighting;
-	Tile *_cacheTile;
-	Tile *_cacheTileBelow;
-	Position _cacheTilePos;
+	/**
+	 * Helper class storing the last tile looked up by voxelCheck.
+	 */
+	struct VoxelCheckCache
+	{
+		Tile *tile = nullptr;
+		Tile *tileBelow = nullptr;
+		Position pos = invalid;
+	};
+	VoxelCheckCache _voxelCheckCache;
+	std::vector<VoxelShape> _voxelShapes;
+	std::map<std::array<const MapData*, O_MAX>, int> _voxelShapeIndex;
+	bool _voxelShapesBuilt = false;
+	Uint32 _voxelShapesRevision = 0;
 	const int _maxViewDistance;        // 20 tiles by default
 	const int _maxViewDistanceSq;      // 20 * 20
 	const int _maxVoxelViewDistance;   // maxViewDistance * 16
@@ -108,9 +174,23 @@ private:
 	const int _maxDynamicLightDistance;
 	const int _enhancedLighting;
 	Position _eventVisibilitySectorL, _eventVisibilitySectorR, _eventVisibilityObserverPos;
+	std::vector<VisibilityRecord> _visibilityIndex;
+	size_t _visibilityIndexUnits = 0;
 	std::vector<BattleUnit*> _movingUnitPrev;
 	BattleUnit* _movingUnit = nullptr;
 
+	/// Gets the voxel shape of a tile, building it if needed.
+	const VoxelShape &getVoxelShape(Tile *tile);
+	/// Builds voxel shapes of all tiles, so voxel checks don't change the map.
+	void updateVoxelShapes();
+	/// Checks if we hit a voxel, using given tile cache.
+	VoxelType voxelCheck(VoxelCheckCache &cache, Position voxel, BattleUnit *excludeUnit, bool excludeAllUnits, bool onlyVisible, BattleUnit *excludeAllBut);
+	/// Calculates a line trajectory, using given tile cache.
+	VoxelType calculateLineVoxel(VoxelCheckCache &cache, Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, BattleUnit *excludeAllBut, bool onlyVisible);
+	/// Checks a unit's % exposure on a tile, using given tile cache.
+	bool canTargetUnit(VoxelCheckCache &cache, Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit);
+	/// Checks for an opposing unit on a tile, reusing the last result if nothing on its path changed.
+	bool visibleIndexed(BattleUnit *observer, size_t observerIndex, BattleUnit *target, size_t targetIndex, int part, Tile *tile, bool fullCheck, Position eventPos, int eventRadius);
 	/// Add light source.
 	void addLight(MapSubset gs, Position center, int power, LightLayers layer);
 	/// Calculate blockage amount.
@@ -247,6 +327,8 @@ public:
 	int checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit *excludeUnit, BattleUnit *excludeAllBut);
 	/// Checks validity for targetting a unit.
 	bool canTargetUnit(Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit = 0);
+	/// Checks many line of fire queries at once, spread over all worker threads.
+	void canTargetUnits(std::vector<LineOfFireQuery> &queries);
 	/// Check validity for targetting a tile.
 	bool canTargetTile(Position *originVoxel, Tile *tile, int part, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles);
 	/// Calculates the z voxel for shadows.
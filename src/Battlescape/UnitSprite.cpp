@@ -29,6 +29,7 @@
 #include "../Engine/ShaderMove.h"
 #include "../Engine/Exception.h"
 #include "../Engine/Options.h"
+#include "../Engine/ScriptBlitCache.h"
 
 namespace OpenXcom
 {
@@ -39,15 +40,16 @@ namespace OpenXcom
  * @param height Height in pixels.
  * @param x X position in pixels.
  * @param y Y position in pixels.
+ * @param cache Optional cache of recolored item sprites.
  */
-UnitSprite::UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet) :
+UnitSprite::UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet, ScriptBlitCache* cache) :
 	_unit(0), _itemR(0), _itemL(0),
 	_unitSurface(0),
 	_itemSurface(mod->getSurfaceSet("HANDOB.PCK")),
 	_fireSurface(mod->getSurfaceSet("SMOKE.PCK")),
 	_breathSurface(mod->getSurfaceSet("BREATH-1.PCK", false)),
 	_facingArrowSurface(mod->getSurfaceSet("DETBLOB.DAT")),
-	_dest(dest), _mod(mod),
+	_dest(dest), _mod(mod), _cache(cache),
 	_part(0), _animationFrame(frame), _drawingRoutine(0),
 	_helmet(helmet),
 	_x(0), _y(0), _shade(0), _burn(0),
@@ -150,7 +152,14 @@ void UnitSprite::blitItem(Part& item)
 
 	_dest->lock();
 
-	work.executeBlit(item.src, _dest,  _x + item.offX, _y + item.offY, _shade, _mask);
+	if (_cache)
+	{
+		_cache->executeBlit(work, item.src, _dest, _x + item.offX, _y + item.offY, _shade, _mask);
+	}
+	else
+	{
+		work.executeBlit(item.src, _dest,  _x + item.offX, _y + item.offY, _shade, _mask);
+	}
 
 	_dest->unlock();
 }
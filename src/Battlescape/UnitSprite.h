@@ -27,6 +27,7 @@ class BattleUnit;
 class BattleItem;
 class SurfaceSet;
 class Mod;
+class ScriptBlitCache;
 
 /**
  * A class that renders a specific unit, given its render rules
@@ -53,6 +54,7 @@ private:
 	SurfaceSet *_unitSurface, *_itemSurface, *_fireSurface, *_breathSurface, *_facingArrowSurface;
 	Surface *_dest;
 	Mod *_mod;
+	ScriptBlitCache *_cache;
 	int _part, _animationFrame, _drawingRoutine;
 	bool _helmet;
 	int _x, _y, _shade, _burn;
@@ -106,7 +108,7 @@ private:
 	void blitBody(Part& body);
 public:
 	/// Creates a new UnitSprite at the specified position and size.
-	UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet);
+	UnitSprite(Surface* dest, Mod* mod, int frame, bool helmet, ScriptBlitCache* cache = nullptr);
 	/// Cleans up the UnitSprite.
 	~UnitSprite();
 	/// Draws the unit.
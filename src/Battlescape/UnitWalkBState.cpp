@@ -443,6 +443,14 @@ void UnitWalkBState::think()
 	}
 }
 
+/**
+ * Marks the walking unit and any unit it revealed or hid to be drawn again.
+ */
+void UnitWalkBState::invalidateMap()
+{
+	_parent->getMap()->invalidateUnits(false, _unit);
+}
+
 /**
  * Aborts unit walking.
  */
@@ -61,6 +61,8 @@ public:
 	void cancel() override;
 	/// Runs state functionality every cycle.
 	void think() override;
+	/// Marks the parts of the map changed by the last think.
+	void invalidateMap() override;
 };
 
 }
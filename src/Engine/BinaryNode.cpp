@@ -0,0 +1,251 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BinaryNode.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Tags stored as a single number instead of a string.
+enum BinaryNodeTag { TAG_NON_SPECIFIC, TAG_NON_PLAIN, TAG_EMPTY, TAG_OTHER };
+/// Deepest node nesting accepted when reading, yaml-cpp itself stops at 2000.
+const int MaxDepth = 2000;
+
+}
+
+/**
+ * Writes a little-endian number of a fixed size.
+ * @param value Number to write.
+ * @param bytes Number of bytes to use.
+ */
+void BinaryNodeWriter::writeFixed(Uint64 value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		_out.push_back((unsigned char)(value >> (i * 8)));
+	}
+}
+
+/**
+ * Writes a number seven bits at a time, small numbers take a single byte.
+ * @param value Number to write.
+ */
+void BinaryNodeWriter::writeVarint(Uint64 value)
+{
+	while (value >= 0x80)
+	{
+		_out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	_out.push_back((unsigned char)value);
+}
+
+/**
+ * Writes a string with its length.
+ * @param s String to write.
+ */
+void BinaryNodeWriter::writeString(const std::string &s)
+{
+	writeVarint(s.size());
+	_out.insert(_out.end(), s.begin(), s.end());
+}
+
+/**
+ * Writes a node and all its children. Each node starts with its type
+ * in the low bits and its kind of tag in the high bits of one byte.
+ * @param node Node to write.
+ */
+void BinaryNodeWriter::writeNode(const YAML::Node &node)
+{
+	const std::string &tag = node.Tag();
+	BinaryNodeTag tagKind = TAG_OTHER;
+	if (tag == "?")
+		tagKind = TAG_NON_SPECIFIC;
+	else if (tag == "!")
+		tagKind = TAG_NON_PLAIN;
+	else if (tag.empty())
+		tagKind = TAG_EMPTY;
+
+	_out.push_back((unsigned char)(node.Type() | (tagKind << 3)));
+	if (tagKind == TAG_OTHER)
+	{
+		writeString(tag);
+	}
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		writeString(node.Scalar());
+		break;
+	case YAML::NodeType::Sequence:
+		writeVarint(node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(*i);
+		}
+		break;
+	case YAML::NodeType::Map:
+		writeVarint(node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(i->first);
+			writeNode(i->second);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Reads a little-endian number of a fixed size.
+ * @param bytes Number of bytes used.
+ * @return The number, 0 if out of data.
+ */
+Uint64 BinaryNodeReader::readFixed(int bytes)
+{
+	if (_end - _pos < bytes)
+	{
+		_ok = false;
+		return 0;
+	}
+	Uint64 value = 0;
+	for (int i = 0; i < bytes; ++i)
+	{
+		value |= (Uint64)*_pos++ << (i * 8);
+	}
+	return value;
+}
+
+/**
+ * Reads a number written seven bits at a time.
+ * @return The number, 0 if broken.
+ */
+Uint64 BinaryNodeReader::readVarint()
+{
+	Uint64 value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (_pos == _end)
+		{
+			break;
+		}
+		unsigned char byte = *_pos++;
+		value |= (Uint64)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return value;
+		}
+	}
+	_ok = false;
+	return 0;
+}
+
+/**
+ * Reads a string with its length.
+ * @return The string, empty if broken.
+ */
+std::string BinaryNodeReader::readString()
+{
+	Uint64 size = readVarint();
+	if (!_ok || (Uint64)(_end - _pos) < size)
+	{
+		_ok = false;
+		return std::string();
+	}
+	std::string s((const char *)_pos, (size_t)size);
+	_pos += size;
+	return s;
+}
+
+/**
+ * Reads a node and all its children.
+ * @param depth Nesting level of the node.
+ * @return The node, undefined if the data is broken.
+ */
+YAML::Node BinaryNodeReader::readNode(int depth)
+{
+	if (_pos == _end || depth > MaxDepth)
+	{
+		_ok = false;
+		return YAML::Node();
+	}
+	const unsigned char header = *_pos++;
+	const int tagKind = header >> 3;
+	std::string tag;
+	switch (tagKind)
+	{
+	case TAG_NON_SPECIFIC: tag = "?"; break;
+	case TAG_NON_PLAIN: tag = "!"; break;
+	case TAG_EMPTY: break;
+	case TAG_OTHER: tag = readString(); break;
+	default: _ok = false; break;
+	}
+
+	YAML::Node node;
+	switch (header & 7)
+	{
+	case YAML::NodeType::Null:
+		node = YAML::Node(YAML::NodeType::Null);
+		break;
+	case YAML::NodeType::Scalar:
+		node = YAML::Node(readString());
+		break;
+	case YAML::NodeType::Sequence:
+	{
+		node = YAML::Node(YAML::NodeType::Sequence);
+		Uint64 size = readVarint();
+		for (Uint64 i = 0; i < size && _ok; ++i)
+		{
+			node.push_back(readNode(depth + 1));
+		}
+		break;
+	}
+	case YAML::NodeType::Map:
+	{
+		node = YAML::Node(YAML::NodeType::Map);
+		Uint64 size = readVarint();
+		for (Uint64 i = 0; i < size && _ok; ++i)
+		{
+			YAML::Node key = readNode(depth + 1);
+			YAML::Node value = readNode(depth + 1);
+			if (_ok)
+			{
+				node.force_insert(key, value);
+			}
+		}
+		break;
+	}
+	default:
+		_ok = false;
+		break;
+	}
+	if (!_ok)
+	{
+		return YAML::Node();
+	}
+	if (tagKind != TAG_EMPTY)
+	{
+		node.SetTag(tag);
+	}
+	return node;
+}
+
+}
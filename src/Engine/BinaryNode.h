@@ -0,0 +1,75 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Writes YAML node trees in a compact binary form: each node is one byte
+ * holding its type and kind of tag, followed by its tag if unusual, its
+ * text or its children. Style and marks are not kept.
+ */
+class BinaryNodeWriter
+{
+	std::vector<unsigned char> &_out;
+public:
+	/// Creates a writer appending to a buffer.
+	BinaryNodeWriter(std::vector<unsigned char> &out) : _out(out) { }
+	/// Writes a little-endian number of a fixed size.
+	void writeFixed(Uint64 value, int bytes);
+	/// Writes a number in as few bytes as possible.
+	void writeVarint(Uint64 value);
+	/// Writes a string with its length.
+	void writeString(const std::string &s);
+	/// Writes a node and all its children.
+	void writeNode(const YAML::Node &node);
+};
+
+/**
+ * Reads data written by BinaryNodeWriter, failing on anything out of bounds.
+ */
+class BinaryNodeReader
+{
+	const unsigned char *_pos, *_end;
+	bool _ok;
+public:
+	/// Creates a reader of a range of bytes.
+	BinaryNodeReader(const unsigned char *begin, const unsigned char *end) : _pos(begin), _end(end), _ok(true) { }
+	/// Checks whether all reads so far were valid.
+	bool ok() const { return _ok; }
+	/// Checks whether all the data was read.
+	bool atEnd() const { return _pos == _end; }
+	/// Gets the position of the next read.
+	const unsigned char *getPosition() const { return _pos; }
+	/// Reads a little-endian number of a fixed size.
+	Uint64 readFixed(int bytes);
+	/// Reads a number of variable size.
+	Uint64 readVarint();
+	/// Reads a string with its length.
+	std::string readString();
+	/// Reads a node and all its children.
+	YAML::Node readNode(int depth = 0);
+};
+
+}
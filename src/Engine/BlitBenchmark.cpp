@@ -0,0 +1,260 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BlitBenchmark.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "Logger.h"
+#include "RNG.h"
+#include "ShaderDraw.h"
+#include "ShaderMove.h"
+#include "../Geoscape/Globe.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+struct BenchmarkSize
+{
+	int width, height;
+};
+
+/// Surface sizes from the original game screen up to full HD.
+const BenchmarkSize BenchmarkSizes[] = { { 320, 200 }, { 640, 400 }, { 1280, 720 }, { 1920, 1080 } };
+
+/**
+ * Runs a kernel a number of times.
+ * @param passes Number of runs.
+ * @param f Kernel to run.
+ * @return Average time of one run in microseconds.
+ */
+template<typename Func>
+double timePasses(int passes, Func&& f)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < passes; ++i)
+	{
+		f();
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / passes;
+}
+
+/**
+ * Adds one kernel timing to the report.
+ * @param report Report to add to.
+ * @param kernel Name of the kernel.
+ * @param set Name of the instruction set.
+ * @param time Time of one run.
+ * @param scalarTime Time of one run of the scalar version.
+ * @param same Does the result match the scalar version?
+ */
+void reportTime(std::ostream &report, const char *kernel, const char *set, double time, double scalarTime, bool same)
+{
+	report << "  " << std::left << std::setw(9) << kernel << std::setw(8) << set << std::right;
+	report << std::fixed << std::setw(10) << std::setprecision(1) << time << " us";
+	report << "  x" << std::setprecision(2) << (time > 0 ? scalarTime / time : 0.0);
+	if (!same)
+	{
+		report << "  MISMATCH";
+	}
+	report << std::endl;
+}
+
+/**
+ * Builds normal vectors of a sphere filling the buffer, like the globe data.
+ * @param width Width of the buffer.
+ * @param height Height of the buffer.
+ * @return Normals, zero outside of the sphere.
+ */
+std::vector<Cord> sphereNormals(int width, int height)
+{
+	std::vector<Cord> earth(width * height);
+	const double r = height / 2 - 1;
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const double dx = (x - width / 2) / r;
+			const double dy = (y - height / 2) / r;
+			const double d = dx * dx + dy * dy;
+			if (d < 1.0)
+			{
+				earth[y * width + x] = Cord(dx, dy, std::sqrt(1.0 - d));
+			}
+		}
+	}
+	return earth;
+}
+
+}
+
+/**
+ * Sets up a blit benchmark.
+ * @param passes How many times each kernel is run on every surface size.
+ */
+BlitBenchmark::BlitBenchmark(int passes) : _passes(passes)
+{
+}
+
+/**
+ *
+ */
+BlitBenchmark::~BlitBenchmark()
+{
+}
+
+/**
+ * Runs every kernel on every surface size with all supported
+ * instruction sets and prints the average time of one pass.
+ * @return Exit code, failure if any vector kernel gave different results than the scalar one.
+ */
+int BlitBenchmark::run()
+{
+	Log(LOG_INFO) << "Blit benchmark: " << _passes << " passes, best kernels: " << helper::getRowKernels().name;
+
+	std::ostringstream report;
+	bool allSame = true;
+	RNG::RandomState random(1);
+	const int shade = 3;
+	const int newColor = 5 << 4;
+	const helper::RowKernels *scalar = helper::getRowKernels(helper::ROW_KERNELS_SCALAR);
+
+	for (const auto &size : BenchmarkSizes)
+	{
+		const int width = size.width;
+		const int height = size.height;
+		const int pixels = width * height;
+		report << "Blit benchmark: " << width << "x" << height << std::endl;
+
+		std::vector<Uint8> src(pixels), start(pixels);
+		for (int i = 0; i < pixels; ++i)
+		{
+			// about quarter of sprite pixels are transparent
+			src[i] = random.generate(0, 3) ? random.generate(1, 255) : 0;
+			start[i] = random.generate(0, 255);
+		}
+
+		// row kernels, every run goes over whole surface
+		const char *kernelNames[] = { "copy", "shade", "replace" };
+		for (int kernel = 0; kernel < 3; ++kernel)
+		{
+			std::vector<Uint8> expected;
+			double scalarTime = 0;
+			for (int type = 0; type < helper::ROW_KERNELS_MAX; ++type)
+			{
+				const helper::RowKernels *k = helper::getRowKernels((helper::RowKernelsType)type);
+				if (!k)
+				{
+					continue;
+				}
+				std::vector<Uint8> dest = start;
+				const double time = timePasses(_passes, [&]
+				{
+					for (int y = 0; y < height; ++y)
+					{
+						Uint8 *d = dest.data() + y * width;
+						const Uint8 *s = src.data() + y * width;
+						switch (kernel)
+						{
+						case 0: k->copy(d, s, width); break;
+						case 1: k->shade(d, s, width, shade); break;
+						default: k->replace(d, s, width, shade, newColor); break;
+						}
+					}
+				});
+				if (k == scalar)
+				{
+					expected = dest;
+					scalarTime = time;
+				}
+				const bool same = dest == expected;
+				allSame = allSame && same;
+				reportTime(report, kernelNames[kernel], k->name, time, scalarTime, same);
+			}
+		}
+
+		// background fill of the battlescape map
+		{
+			const Uint8 color = 15;
+			std::vector<Uint8> dest(pixels);
+			const double scalarTime = timePasses(_passes, [&]
+			{
+				ShaderDrawFunc(
+					[](Uint8& d, Uint8 c)
+					{
+						d = c;
+					},
+					ShaderSurface(SurfaceRaw<Uint8>(dest, width, height)),
+					ShaderScalar<Uint8>(color)
+				);
+			});
+			reportTime(report, "fill", scalar->name, scalarTime, scalarTime, true);
+			const double rowTime = timePasses(_passes, [&]
+			{
+				ShaderDraw<helper::Fill>(ShaderSurface(SurfaceRaw<Uint8>(dest, width, height)), ShaderScalar<Uint8>(color));
+			});
+			reportTime(report, "fill", "memset", rowTime, scalarTime, true);
+		}
+
+		// globe shadow, land and ocean colors on a lit sphere
+		{
+			std::vector<Cord> earth = sphereNormals(width, height);
+			std::vector<Uint8> globe(pixels);
+			for (int i = 0; i < pixels; ++i)
+			{
+				globe[i] = earth[i].z ? random.generate(16, 255) : 0;
+			}
+			Cord sun(0.6, -0.3, 0.5);
+			sun *= 1. / sun.norm();
+
+			std::vector<Uint8> expected = globe;
+			const double scalarTime = timePasses(_passes, [&]
+			{
+				Globe::drawShadow(SurfaceRaw<Uint8>(expected, width, height), SurfaceRaw<Cord>(earth, width, height), 0, 0, sun, false);
+			});
+			reportTime(report, "shadow", scalar->name, scalarTime, scalarTime, true);
+
+			std::vector<Uint8> dest = globe;
+			const double rowTime = timePasses(_passes, [&]
+			{
+				Globe::drawShadow(SurfaceRaw<Uint8>(dest, width, height), SurfaceRaw<Cord>(earth, width, height), 0, 0, sun, true);
+			});
+			const bool same = dest == expected;
+			allSame = allSame && same;
+			reportTime(report, "shadow", "rows", rowTime, scalarTime, same);
+		}
+	}
+
+	std::cout << report.str();
+	Log(LOG_INFO) << report.str();
+	if (!allSame)
+	{
+		Log(LOG_ERROR) << "Blit benchmark: vector kernels gave different results than scalar ones.";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace OpenXcom
+{
+
+/**
+ * Micro-benchmark of the blit kernels used by `ShaderDraw`.
+ * Every kernel is run on screen sized buffers with scalar code
+ * and every vector instruction set the CPU supports, timings
+ * are printed and results are checked against the scalar ones.
+ */
+class BlitBenchmark
+{
+private:
+	int _passes;
+public:
+	/// Creates a blit benchmark.
+	BlitBenchmark(int passes);
+	/// Cleans up the benchmark.
+	~BlitBenchmark();
+	/// Runs all kernels and prints the timings.
+	int run();
+};
+
+}
@@ -44,6 +44,7 @@
 #include <shellapi.h>
 #include <wininet.h>
 #include <urlmon.h>
+#include <psapi.h>
 #ifndef __NO_DBGHELP
 #include <dbghelp.h>
 #endif
@@ -57,6 +58,7 @@
 #pragma comment(lib, "shlwapi.lib")
 #pragma comment(lib, "wininet.lib")
 #pragma comment(lib, "urlmon.lib")
+#pragma comment(lib, "psapi.lib")
 #ifndef __NO_DBGHELP
 #pragma comment(lib, "dbghelp.lib")
 #endif
@@ -77,6 +79,7 @@
 #include <cxxabi.h>
 #include <dlfcn.h>
 #include <dirent.h>
+#include <sys/resource.h>
 #include "Unicode.h"
 #endif		/* #ifdef _WIN32 */
 #include <SDL.h>
@@ -1374,6 +1377,29 @@ std::string now()
 	return result;
 }
 
+/**
+ * Gets the most physical memory the process has used so far.
+ * @return Peak resident set size in bytes, 0 if unknown.
+ */
+size_t getPeakMemoryUsage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss;
+#else
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
 /**
  * Logs the details of this crash and shows an error.
  * @param ex Pointer to exception data (PEXCEPTION_POINTERS on Windows, signal int on Unix)
@@ -105,6 +105,8 @@ namespace CrossPlatform
 	void stackTrace(void *ctx);
 	/// Produces a quick timestamp.
 	std::string now();
+	/// Gets the peak memory usage of the process.
+	size_t getPeakMemoryUsage();
 	/// Produces a crash dump.
 	void crashDump(void *ex, const std::string &err);
 	/// Log something.
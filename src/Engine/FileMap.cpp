@@ -282,6 +282,26 @@ std::unique_ptr<std::istream> FileRecord::getIStream() const
 	}
 }
 
+void FileRecord::getStat(Uint64 &size, Uint64 &stamp) const
+{
+	size = 0;
+	stamp = 0;
+	if (zip != NULL) {
+		mz_zip_archive_file_stat fistat;
+		if (mz_zip_reader_file_stat((mz_zip_archive *)zip, (mz_uint)findex, &fistat)) {
+			size = fistat.m_uncomp_size;
+			stamp = fistat.m_crc32;
+		}
+	} else {
+		SDL_RWops *rwops = SDL_RWFromFile(fullpath.c_str(), "rb");
+		if (rwops) {
+			size = SDL_RWsize(rwops);
+			SDL_RWclose(rwops);
+		}
+		stamp = CrossPlatform::getDateModified(fullpath);
+	}
+}
+
 YAML::Node FileRecord::getYAML() const
 {
 	try
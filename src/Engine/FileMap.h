@@ -51,6 +51,8 @@ namespace FileMap
 		SDL_RWops *getRWopsReadAll() const;
 
 		std::unique_ptr<std::istream> getIStream() const;
+		/// Gets the size and a stamp that changes with the contents (mtime, or CRC-32 inside zips).
+		void getStat(Uint64 &size, Uint64 &stamp) const;
 		YAML::Node getYAML() const;
 		std::vector<YAML::Node> getAllYAML() const;
 	};
@@ -19,6 +19,7 @@
 #include "Game.h"
 #include "../resource.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <SDL_mixer.h>
@@ -39,6 +40,8 @@
 #include "CrossPlatform.h"
 #include "FileMap.h"
 #include "Unicode.h"
+#include "WorkerPool.h"
+#include "ScriptProfiler.h"
 #include "../Menu/NotesState.h"
 #include "../Menu/TestState.h"
 #include <algorithm>
@@ -96,11 +99,14 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	SDL_SetCursor(SDL_CreateCursor(&cursor, &cursor, 1,1,0,0));
 
 	// Create fps counter
-	_fpsCounter = new FpsCounter(15, 5, 0, 0);
+	_fpsCounter = new FpsCounter(23, 11, 0, 0);
 
 	// Create blank language
 	_lang = new Language();
 
+	// Start background threads
+	WorkerPool::start(Options::oxceWorkerThreads);
+
 	_timeOfLastFrame = 0;
 }
 
@@ -109,8 +115,14 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
  */
 Game::~Game()
 {
+	if (ScriptProfiler::isEnabled())
+	{
+		ScriptProfiler::save();
+	}
+
 	Sound::stop();
 	Music::stop();
+	WorkerPool::stop();
 
 	for (std::list<State*>::iterator i = _states.begin(); i != _states.end(); ++i)
 	{
@@ -290,6 +302,11 @@ void Game::run()
 								Options::debugUi = !Options::debugUi;
 								_states.back()->redrawText();
 							}
+							// "ctrl-p" save script profile
+							else if (action.getDetails()->key.keysym.sym == SDLK_p && (SDL_GetModState() & KMOD_CTRL) != 0 && ScriptProfiler::isEnabled())
+							{
+								ScriptProfiler::save();
+							}
 						}
 					}
 					_states.back()->handle(&action);
@@ -340,7 +357,9 @@ void Game::run()
 				}
 				_fpsCounter->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
+				auto flipStart = std::chrono::steady_clock::now();
 				_screen->flip();
+				_fpsCounter->addFrameTime(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - flipStart).count());
 			}
 		}
 
@@ -358,6 +377,62 @@ void Game::run()
 	Options::save();
 }
 
+/**
+ * Runs a single logic cycle of the state machine, like run()
+ * but without polling events, rendering or frame pacing.
+ * Used by the headless benchmarks to drive the game as fast
+ * as the logic allows, together with Timer::fastForward.
+ */
+void Game::thinkHeadless()
+{
+	// Clean up states
+	while (!_deleted.empty())
+	{
+		delete _deleted.back();
+		_deleted.pop_back();
+	}
+
+	if (_states.empty())
+	{
+		return;
+	}
+
+	// Initialize active state
+	if (!_init)
+	{
+		_init = true;
+		_states.back()->init();
+	}
+
+	// Process logic
+	_states.back()->think();
+}
+
+/**
+ * Closes the state on top of the stack as if the player had
+ * confirmed it, used to get past popups when running headless.
+ * States that don't react to the key are simply popped.
+ * @param cancel Press Cancel instead of OK.
+ */
+void Game::dismissTopState(bool cancel)
+{
+	if (_states.empty())
+	{
+		return;
+	}
+	State *top = _states.back();
+	SDL_Event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.type = SDL_KEYDOWN;
+	ev.key.keysym.sym = cancel ? Options::keyCancel : Options::keyOk;
+	Action action = Action(&ev, _screen->getXScale(), _screen->getYScale(), _screen->getCursorTopBlackBand(), _screen->getCursorLeftBlackBand());
+	top->handle(&action);
+	if (!_states.empty() && _states.back() == top)
+	{
+		popState();
+	}
+}
+
 /**
  * Stops the state machine and the game is shut down.
  */
@@ -475,6 +550,8 @@ void Game::loadMods()
 {
 	Mod::resetGlobalStatics();
 	delete _mod;
+	ScriptProfiler::clear();
+	ScriptProfiler::setEnabled(Options::oxceScriptProfiler);
 	_mod = new Mod();
 	_mod->loadAll();
 }
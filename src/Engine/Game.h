@@ -63,6 +63,10 @@ public:
 	~Game();
 	/// Starts the game's state machine.
 	void run();
+	/// Runs one cycle of the state machine without input or rendering.
+	void thinkHeadless();
+	/// Confirms or pops the state on top of the stack.
+	void dismissTopState(bool cancel = false);
 	/// Quits the game.
 	void quit();
 	/// Sets the game's audio volume.
@@ -95,6 +99,8 @@ public:
 	void setMouseActive(bool active);
 	/// Returns whether current state is the param state
 	bool isState(State *state) const;
+	/// Gets the state on top of the state stack.
+	State *getTopState() const { return _states.empty() ? 0 : _states.back(); }
 	/// Returns whether the game is shutting down.
 	bool isQuitting() const;
 	/// Loads the default and current language.
@@ -149,7 +149,7 @@ void OpenGL::clear() {
 	glErrorCheck();
 }
 
-void OpenGL::refresh(bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand)
+void OpenGL::refresh(const SDL_Surface *image, bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand)
 {
 	while (glGetError() != GL_NO_ERROR); // clear possible error from who knows where
 	clear();
@@ -190,13 +190,13 @@ void OpenGL::refresh(bool smooth, unsigned inwidth, unsigned inheight, unsigned
 
 	glErrorCheck();
 
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch / surface->format->BytesPerPixel);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, image->pitch / image->format->BytesPerPixel);
 
 	glErrorCheck();
 
 	glTexSubImage2D(GL_TEXTURE_2D,
 		/* mip-map level = */ 0, /* x = */ 0, /* y = */ 0,
-		iwidth, iheight, GL_BGRA, iformat, buffer);
+		iwidth, iheight, GL_BGRA, iformat, image->pixels);
 
 
 	//OpenGL projection sets 0,0 as *bottom-left* of screen.
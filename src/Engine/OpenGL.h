@@ -62,8 +62,8 @@ public:
   bool lock(uint32_t *&data, unsigned &pitch);
   /// make all the pixels go away
   void clear();
-  /// make the buffer show up on screen
-  void refresh(bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand);
+  /// make the image show up on screen, image must have the buffer's size and format
+  void refresh(const SDL_Surface *image, bool smooth, unsigned inwidth, unsigned inheight, unsigned outwidth, unsigned outheight, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand);
   /// set a shader! but what kind?
   bool set_shader(const char *source);
   /// same but for fragment shader?
@@ -55,6 +55,14 @@ std::string _masterMod;
 int _passwordCheck = -1;
 bool _loadLastSave = false;
 bool _loadLastSaveExpended = false;
+std::string _battleBenchmark;
+int _benchmarkTurns = 10;
+std::string _geoscapeBenchmark;
+int _benchmarkDays = 30;
+uint64_t _benchmarkSeed = 1;
+int _blitBenchmark = 0;
+int _scalerBenchmark = 0;
+int _scriptBenchmark = 0;
 
 /**
  * Sets up the options by creating their OptionInfo metadata.
@@ -231,6 +239,13 @@ void create()
 	_info.push_back(OptionInfo("oxceEnablePaletteFlickerFix", &oxceEnablePaletteFlickerFix, false));
 	_info.push_back(OptionInfo("oxcePersonalLayoutIncludingArmor", &oxcePersonalLayoutIncludingArmor, true));
 	_info.push_back(OptionInfo("oxceManufactureFilterSuppliesOK", &oxceManufactureFilterSuppliesOK, false));
+	_info.push_back(OptionInfo("oxceWorkerThreads", &oxceWorkerThreads, 0)); // 0 = one less than the number of cores
+	_info.push_back(OptionInfo("oxceThreadedFlip", &oxceThreadedFlip, false)); // scale and flip frames on a separate thread
+	_info.push_back(OptionInfo("oxceRulesetCache", &oxceRulesetCache, true));
+	_info.push_back(OptionInfo("oxceBinaryBattleSaves", &oxceBinaryBattleSaves, false)); // true = battles are saved in the binary container
+	_info.push_back(OptionInfo("oxceScriptOptimizer", &oxceScriptOptimizer, true)); // simplify mod scripts after parsing
+	_info.push_back(OptionInfo("oxceScriptProfiler", &oxceScriptProfiler, false)); // time every mod script, saved to script_profile.csv
+	_info.push_back(OptionInfo("oxceGeoSkipIdleTicks", &oxceGeoSkipIdleTicks, true)); // don't run geoscape 5-second ticks that provably change nothing
 
 	// OXCE hidden but moddable
 	_info.push_back(OptionInfo("oxceStartUpTextMode", &oxceStartUpTextMode, 0, "", "HIDDEN"));
@@ -502,6 +517,38 @@ static void loadArgs()
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "battlebenchmark")
+				{
+					_battleBenchmark = argv[i];
+				}
+				else if (argname == "benchmarkturns")
+				{
+					_benchmarkTurns = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "geoscapebenchmark")
+				{
+					_geoscapeBenchmark = argv[i];
+				}
+				else if (argname == "benchmarkdays")
+				{
+					_benchmarkDays = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "benchmarkseed")
+				{
+					_benchmarkSeed = strtoull(argv[i].c_str(), 0, 10);
+				}
+				else if (argname == "blitbenchmark")
+				{
+					_blitBenchmark = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "scalerbenchmark")
+				{
+					_scalerBenchmark = std::max(1, atoi(argv[i].c_str()));
+				}
+				else if (argname == "scriptbenchmark")
+				{
+					_scriptBenchmark = std::max(1, atoi(argv[i].c_str()));
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -534,6 +581,28 @@ static bool showHelp()
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-battleBenchmark SAVE" << std::endl;
+	help << "        play SAVE (a battlescape save in the master mod user folder) without video," << std::endl;
+	help << "        ending player turns, and print AI/pathfinding/FOV/lighting/explosion timings" << std::endl << std::endl;
+	help << "-benchmarkTurns N" << std::endl;
+	help << "        number of full turns to play in benchmark mode (default 10)" << std::endl << std::endl;
+	help << "-geoscapeBenchmark SAVE" << std::endl;
+	help << "        run the campaign in SAVE (a geoscape save in the master mod user folder) without video" << std::endl;
+	help << "        at the fastest speed, dismissing popups, and print throughput, peak memory and" << std::endl;
+	help << "        time5Seconds/time10Minutes/.../time1Month timings" << std::endl << std::endl;
+	help << "-benchmarkDays N" << std::endl;
+	help << "        number of game days to simulate in geoscape benchmark mode (default 30)" << std::endl << std::endl;
+	help << "-benchmarkSeed N" << std::endl;
+	help << "        RNG seed used in benchmark mode, for repeatable runs (default 1)" << std::endl << std::endl;
+	help << "-blitBenchmark N" << std::endl;
+	help << "        run every blit kernel N times on surfaces from 320x200 to 1920x1080," << std::endl;
+	help << "        print scalar and vector timings and exit" << std::endl << std::endl;
+	help << "-scalerBenchmark N" << std::endl;
+	help << "        scale N frames with every hqNx and xBRZ scaler on 1, 2, 4... threads," << std::endl;
+	help << "        print milliseconds per frame and exit" << std::endl << std::endl;
+	help << "-scriptBenchmark N" << std::endl;
+	help << "        run sample unit scripts N times with and without the script optimizer," << std::endl;
+	help << "        print runs and operations per second and exit" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -867,6 +936,78 @@ void expendLoadLastSave()
 	_loadLastSaveExpended = true;
 }
 
+/**
+ * Gets the battlescape save to benchmark, if any.
+ * @return Save filename, empty for a normal game.
+ */
+const std::string &getBattleBenchmark()
+{
+	return _battleBenchmark;
+}
+
+/**
+ * Gets how many full turns a benchmark should play.
+ * @return Number of turns.
+ */
+int getBenchmarkTurns()
+{
+	return _benchmarkTurns;
+}
+
+/**
+ * Gets the geoscape save to benchmark, if any.
+ * @return Save filename, empty for a normal game.
+ */
+const std::string &getGeoscapeBenchmark()
+{
+	return _geoscapeBenchmark;
+}
+
+/**
+ * Gets how many game days a geoscape benchmark should simulate.
+ * @return Number of days.
+ */
+int getBenchmarkDays()
+{
+	return _benchmarkDays;
+}
+
+/**
+ * Gets the fixed RNG seed for benchmarks.
+ * @return Seed.
+ */
+uint64_t getBenchmarkSeed()
+{
+	return _benchmarkSeed;
+}
+
+/**
+ * Gets how many passes the blit benchmark should run.
+ * @return Number of passes, zero for a normal game.
+ */
+int getBlitBenchmark()
+{
+	return _blitBenchmark;
+}
+
+/**
+ * Gets how many frames the scaler benchmark should scale.
+ * @return Number of frames, zero for a normal game.
+ */
+int getScalerBenchmark()
+{
+	return _scalerBenchmark;
+}
+
+/**
+ * Gets how many times the script benchmark should run each script.
+ * @return Number of runs, zero for a normal game.
+ */
+int getScriptBenchmark()
+{
+	return _scriptBenchmark;
+}
+
 /**
  * Sets up the game's Data folder where the data file
  * are loaded from and the User folder and Config
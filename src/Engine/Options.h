@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <SDL.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include "OptionInfo.h"
@@ -116,6 +117,22 @@ namespace Options
 	bool getLoadLastSave();
 	/// And do it only at startup
 	void expendLoadLastSave();
+	/// Gets the battlescape save to run headless, if any.
+	const std::string &getBattleBenchmark();
+	/// Gets the number of turns to run headless.
+	int getBenchmarkTurns();
+	/// Gets the geoscape save to run headless, if any.
+	const std::string &getGeoscapeBenchmark();
+	/// Gets the number of game days to run headless.
+	int getBenchmarkDays();
+	/// Gets the RNG seed to use when running headless.
+	uint64_t getBenchmarkSeed();
+	/// Gets the number of blit benchmark passes to run.
+	int getBlitBenchmark();
+	/// Gets the number of frames the scaler benchmark scales.
+	int getScalerBenchmark();
+	/// Gets the number of times the script benchmark runs each script.
+	int getScriptBenchmark();
 }
 
 }
@@ -80,6 +80,13 @@ OPT bool oxceEnableSlackingIndicator;
 OPT bool oxceEnablePaletteFlickerFix;
 OPT bool oxcePersonalLayoutIncludingArmor;
 OPT bool oxceManufactureFilterSuppliesOK;
+OPT int oxceWorkerThreads;
+OPT bool oxceThreadedFlip;
+OPT bool oxceRulesetCache;
+OPT bool oxceBinaryBattleSaves;
+OPT bool oxceScriptOptimizer;
+OPT bool oxceScriptProfiler;
+OPT bool oxceGeoSkipIdleTicks;
 
 // OXCE hidden, but moddable via fixedUserOptions and/or recommendedUserOptions
 OPT int oxceStartUpTextMode;
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <iomanip>
+
+namespace OpenXcom
+{
+
+bool Profiler::_enabled = false;
+int Profiler::_depth[PROF_MAX] = {};
+Uint64 Profiler::_calls[PROF_MAX] = {};
+Uint64 Profiler::_nanoseconds[PROF_MAX] = {};
+
+/**
+ * Turns the profiler on or off. Counters are
+ * always cleared so each run starts fresh.
+ * @param enabled Collect timings?
+ */
+void Profiler::setEnabled(bool enabled)
+{
+	reset();
+	_enabled = enabled;
+}
+
+/**
+ * Clears all the collected counters.
+ */
+void Profiler::reset()
+{
+	for (int i = 0; i < PROF_MAX; ++i)
+	{
+		_depth[i] = 0;
+		_calls[i] = 0;
+		_nanoseconds[i] = 0;
+	}
+}
+
+/**
+ * Gets the human-readable name of a section.
+ * @param section Section ID.
+ * @return Section name.
+ */
+const char *Profiler::getName(ProfilerSection section)
+{
+	switch (section)
+	{
+	case PROF_AI_THINK: return "AI think";
+	case PROF_PATHFINDING: return "Pathfinding";
+	case PROF_FOV: return "FOV";
+	case PROF_LIGHTING: return "Lighting";
+	case PROF_EXPLOSIONS: return "Explosions";
+	case PROF_TIME_5SEC: return "time5Seconds";
+	case PROF_TIME_10MIN: return "time10Minutes";
+	case PROF_TIME_30MIN: return "time30Minutes";
+	case PROF_TIME_1HOUR: return "time1Hour";
+	case PROF_TIME_1DAY: return "time1Day";
+	case PROF_TIME_1MONTH: return "time1Month";
+	default: return "?";
+	}
+}
+
+/**
+ * Writes the calls, total time and average time of
+ * every section that was entered at least once.
+ * Sections can nest (FOV inside AI think), so the
+ * totals are inclusive and don't add up to the run time.
+ * @param out Stream to write to.
+ */
+void Profiler::report(std::ostream &out)
+{
+	out << std::left << std::setw(16) << "Section" << std::right << std::setw(12) << "Calls" << std::setw(14) << "Total ms" << std::setw(14) << "Avg us" << std::endl;
+	for (int i = 0; i < PROF_MAX; ++i)
+	{
+		if (_calls[i] == 0)
+		{
+			continue;
+		}
+		double total = _nanoseconds[i] / 1000000.0;
+		double avg = _nanoseconds[i] / 1000.0 / _calls[i];
+		out << std::left << std::setw(16) << getName((ProfilerSection)i) << std::right << std::setw(12) << _calls[i];
+		out << std::fixed << std::setprecision(3) << std::setw(14) << total << std::setw(14) << avg << std::endl;
+	}
+}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+#include <chrono>
+#include <ostream>
+
+namespace OpenXcom
+{
+
+/// Engine code paths that can be timed by the Profiler.
+enum ProfilerSection
+{
+	PROF_AI_THINK,
+	PROF_PATHFINDING,
+	PROF_FOV,
+	PROF_LIGHTING,
+	PROF_EXPLOSIONS,
+	PROF_TIME_5SEC,
+	PROF_TIME_10MIN,
+	PROF_TIME_30MIN,
+	PROF_TIME_1HOUR,
+	PROF_TIME_1DAY,
+	PROF_TIME_1MONTH,
+	PROF_MAX
+};
+
+/**
+ * Opt-in accumulator of wall-clock time spent in the engine's hot paths.
+ * Used by the benchmark modes; while disabled every scope costs one branch.
+ * Nested scopes of the same section are only counted once, so recursive
+ * calls don't inflate the totals.
+ */
+class Profiler
+{
+	static bool _enabled;
+	static int _depth[PROF_MAX];
+	static Uint64 _calls[PROF_MAX];
+	static Uint64 _nanoseconds[PROF_MAX];
+public:
+	/**
+	 * Times a section from construction until the end of the enclosing block.
+	 */
+	class Scope
+	{
+		ProfilerSection _section;
+		bool _tracked, _active;
+		std::chrono::steady_clock::time_point _start;
+	public:
+		/// Starts timing a section.
+		Scope(ProfilerSection section) : _section(section), _tracked(_enabled), _active(false)
+		{
+			if (_tracked)
+			{
+				_active = (_depth[_section]++ == 0);
+				if (_active)
+				{
+					_start = std::chrono::steady_clock::now();
+				}
+			}
+		}
+		/// Stops timing the section.
+		~Scope()
+		{
+			if (_tracked)
+			{
+				_depth[_section]--;
+				if (_active)
+				{
+					_nanoseconds[_section] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+					_calls[_section]++;
+				}
+			}
+		}
+		Scope(const Scope&) = delete;
+		Scope &operator=(const Scope&) = delete;
+	};
+
+	/// Turns the profiler on or off, clearing all counters.
+	static void setEnabled(bool enabled);
+	/// Is the profiler collecting data?
+	static bool isEnabled() { return _enabled; }
+	/// Clears all counters.
+	static void reset();
+	/// Gets the name of a section.
+	static const char *getName(ProfilerSection section);
+	/// Gets how many times a section was entered.
+	static Uint64 getCalls(ProfilerSection section) { return _calls[section]; }
+	/// Gets the total time spent in a section.
+	static Uint64 getNanoseconds(ProfilerSection section) { return _nanoseconds[section]; }
+	/// Writes a table of all sections to a stream.
+	static void report(std::ostream &out);
+};
+
+}
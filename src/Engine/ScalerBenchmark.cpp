@@ -0,0 +1,204 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScalerBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+#include "Logger.h"
+#include "RNG.h"
+#include "WorkerPool.h"
+#include "Zoom.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+struct BenchmarkSize
+{
+	int width, height;
+};
+
+/// Base resolutions, the second one is scaled 4x to 1080p.
+const BenchmarkSize BenchmarkSizes[] = { { 320, 200 }, { 480, 270 } };
+
+struct BenchmarkScaler
+{
+	const char *name;
+	int factor;
+	bool xbrz;
+};
+
+const BenchmarkScaler BenchmarkScalers[] =
+{
+	{ "hq2x", 2, false }, { "hq3x", 3, false }, { "hq4x", 4, false },
+	{ "xbrz2x", 2, true }, { "xbrz3x", 3, true }, { "xbrz4x", 4, true }, { "xbrz5x", 5, true }, { "xbrz6x", 6, true },
+};
+
+/**
+ * Builds a frame looking a bit like the game screen: flat areas
+ * of few colors with noisy edges, so the scalers have work to do.
+ * @param width Width of the frame.
+ * @param height Height of the frame.
+ * @return 32bpp pixels.
+ */
+std::vector<Uint32> makeFrame(int width, int height)
+{
+	RNG::RandomState random(1);
+	Uint32 colors[16];
+	for (int i = 0; i < 16; ++i)
+	{
+		colors[i] = (Uint32)random.generate(0, 0xFFFFFF);
+	}
+	std::vector<Uint32> frame(width * height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			int area = (x / 12 + y / 9 * 3) % 16;
+			frame[y * width + x] = random.generate(0, 7) ? colors[area] : colors[random.generate(0, 15)];
+		}
+	}
+	return frame;
+}
+
+/**
+ * Scales a frame with one of the scalers.
+ * @param scaler Scaler to use.
+ * @param src Source frame.
+ * @param dst Scaled frame.
+ * @param width Width of the source frame.
+ * @param height Height of the source frame.
+ * @param bands Number of bands to split the frame into.
+ */
+void scaleFrame(const BenchmarkScaler &scaler, const std::vector<Uint32> &src, std::vector<Uint32> &dst, int width, int height, int bands)
+{
+	if (scaler.xbrz)
+	{
+		Zoom::scaleXbrz(scaler.factor, src.data(), dst.data(), width, height, bands);
+	}
+	else
+	{
+		Zoom::scaleHqx(scaler.factor, src.data(), width * 4, dst.data(), width * scaler.factor * 4, width, height, bands);
+	}
+}
+
+}
+
+/**
+ * Sets up a scaler benchmark.
+ * @param frames How many frames each scaler scales for every thread count.
+ */
+ScalerBenchmark::ScalerBenchmark(int frames) : _frames(frames)
+{
+}
+
+/**
+ *
+ */
+ScalerBenchmark::~ScalerBenchmark()
+{
+}
+
+/**
+ * Runs every scaler on every base resolution with 1, 2, 4... threads
+ * up to the number of cores and prints the time of one frame.
+ * @return Exit code, failure if any banded frame differs from the whole frame.
+ */
+int ScalerBenchmark::run()
+{
+	int cores = std::min((int)std::thread::hardware_concurrency(), 16);
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads < cores; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(std::max(cores, 1));
+	Log(LOG_INFO) << "Scaler benchmark: " << _frames << " frames, up to " << threadCounts.back() << " threads";
+
+	std::ostringstream report;
+	bool allSame = true;
+	for (const auto &size : BenchmarkSizes)
+	{
+		const int width = size.width;
+		const int height = size.height;
+		std::vector<Uint32> src = makeFrame(width, height);
+
+		for (const auto &scaler : BenchmarkScalers)
+		{
+			report << "Scaler benchmark: " << scaler.name << " " << width << "x" << height << " -> " << width * scaler.factor << "x" << height * scaler.factor << std::endl;
+
+			std::vector<Uint32> expected(width * height * scaler.factor * scaler.factor);
+			WorkerPool::stop();
+			scaleFrame(scaler, src, expected, width, height, 1);
+
+			double singleTime = 0;
+			for (int threads : threadCounts)
+			{
+				WorkerPool::stop();
+				if (threads > 1)
+				{
+					WorkerPool::start(threads - 1);
+				}
+				const int bands = Zoom::getScalerBands(width, height, scaler.factor);
+				std::vector<Uint32> dst(expected.size());
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < _frames; ++i)
+				{
+					scaleFrame(scaler, src, dst, width, height, bands);
+				}
+				const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / _frames;
+				if (threads == 1)
+				{
+					singleTime = time;
+				}
+				const bool same = dst == expected;
+				allSame = allSame && same;
+
+				report << "  " << std::setw(2) << WorkerPool::getThreadCount() << " threads " << std::setw(3) << bands << " bands";
+				report << std::fixed << std::setw(10) << std::setprecision(2) << time << " ms/frame";
+				report << "  x" << std::setprecision(2) << (time > 0 ? singleTime / time : 0.0);
+				if (!same)
+				{
+					report << "  MISMATCH";
+				}
+				report << std::endl;
+			}
+		}
+	}
+	WorkerPool::stop();
+
+	std::cout << report.str();
+	Log(LOG_INFO) << report.str();
+	if (!allSame)
+	{
+		Log(LOG_ERROR) << "Scaler benchmark: banded frames differ from whole frames.";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+}
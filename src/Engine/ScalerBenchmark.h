@@ -0,0 +1,43 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace OpenXcom
+{
+
+/**
+ * Benchmark of the 32bpp screen scalers (xBRZ and hqNx).
+ * Every scaler is run on game sized frames with the worker pool
+ * restarted at increasing thread counts, timings are printed
+ * and banded results are checked against the whole frame ones.
+ */
+class ScalerBenchmark
+{
+private:
+	int _frames;
+public:
+	/// Creates a scaler benchmark.
+	ScalerBenchmark(int frames);
+	/// Cleans up the benchmark.
+	~ScalerBenchmark();
+	/// Runs all scalers and prints the timings.
+	int run();
+};
+
+}
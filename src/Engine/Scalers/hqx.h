@@ -52,4 +52,9 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* src, uint32_t src_rowBytes,
 HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height );
 HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height );
 
+/* Scales only source rows [yFirst, yLast), neighbours outside the slice are still read from the whole image. */
+HQX_API void HQX_CALLCONV hq2x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+HQX_API void HQX_CALLCONV hq3x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+HQX_API void HQX_CALLCONV hq4x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+
 #endif
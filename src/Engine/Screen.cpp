@@ -23,6 +23,8 @@
 #include <iomanip>
 #include <climits>
 #include <cstdio>
+#include <cstring>
+#include <chrono>
 #include "../lodepng.h"
 #include "Exception.h"
 #include "Surface.h"
@@ -112,7 +114,9 @@ void Screen::makeVideoFlags()
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _flickerFix(false)
+Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _flickerFix(false),
+	_presentThread(0), _presentMutex(0), _presentWake(0), _presentDone(0), _presentNumColors(0), _presentFirstColor(0),
+	_presentPending(false), _presentReady(false), _presentClear(false), _clearScreen(false), _presentQuit(false), _presentStats()
 {
 	_flickerFix = Options::oxceEnablePaletteFlickerFix;
 
@@ -126,7 +130,12 @@ Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _sc
  */
 Screen::~Screen()
 {
-
+	stopPresentThread();
+	if (_presentStats.frames > 0)
+	{
+		Log(LOG_INFO) << "Presentation thread: " << _presentStats.frames << " frames, average " << _presentStats.presentTime / _presentStats.frames / 1000.0
+			<< " ms, longest " << _presentStats.maxPresentTime / 1000.0 << " ms, game waited " << _presentStats.waitTime / _presentStats.frames / 1000.0 << " ms per frame.";
+	}
 }
 
 /**
@@ -187,41 +196,164 @@ void Screen::handle(Action *action)
  * If the scaling factor is bigger than 1, the entire contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
  * before being put on screen.
+ * With the presentation thread running, the frame is copied and
+ * handed over to it, so the game can go on with the next frame
+ * while this one gets scaled. Only one frame is ever queued, and
+ * it reaches the window with the next flip, since SDL only lets
+ * the main thread talk to the display.
  */
 void Screen::flip()
 {
+	int numColors = 0;
+	if (_pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
+	{
+		numColors = _numColors;
+		_numColors = 0;
+		_pushPalette = false;
+	}
+
+	if (!_presentThread)
+	{
+		present(_surface.get(), _screen, deferredPalette, _firstColor, numColors, false);
+		if (SDL_Flip(_screen) == -1)
+		{
+			throw Exception(SDL_GetError());
+		}
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	SDL_LockMutex(_presentMutex);
+	while (_presentPending)
+	{
+		SDL_CondWait(_presentDone, _presentMutex);
+	}
+	_presentStats.waitTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	std::string error;
+	error.swap(_presentError);
+	SDL_UnlockMutex(_presentMutex);
+	if (!error.empty())
+	{
+		throw Exception(error);
+	}
+	showPresented();
+
+	if (!_presentSurface || _presentSurface->format->BitsPerPixel != _surface->format->BitsPerPixel ||
+		_presentSurface->w != _surface->w || _presentSurface->h != _surface->h)
+	{
+		if (_surface->format->BitsPerPixel == 32)
+		{
+			std::tie(_presentBuffer, _presentSurface) = Surface::NewPair32Bit(_surface->w, _surface->h);
+		}
+		else
+		{
+			std::tie(_presentBuffer, _presentSurface) = Surface::NewPair8Bit(_surface->w, _surface->h);
+		}
+	}
+	size_t rowSize = _surface->w * _surface->format->BytesPerPixel;
+	for (int y = 0; y < _surface->h; ++y)
+	{
+		memcpy((Uint8*)_presentSurface->pixels + y * _presentSurface->pitch, (const Uint8*)_surface->pixels + y * _surface->pitch, rowSize);
+	}
+	if (_surface->format->palette)
+	{
+		SDL_SetColors(_presentSurface.get(), _surface->format->palette->colors, 0, _surface->format->palette->ncolors);
+	}
+	memcpy(&_presentPalette[_firstColor], &deferredPalette[_firstColor], sizeof(SDL_Color) * numColors);
+	_presentFirstColor = _firstColor;
+	_presentNumColors = numColors;
+	_presentClear = _clearScreen;
+	_clearScreen = false;
+
+	SDL_LockMutex(_presentMutex);
+	_presentPending = true;
+	SDL_CondSignal(_presentWake);
+	SDL_UnlockMutex(_presentMutex);
+}
+
+/**
+ * Converts and scales a finished frame into the game window, or into
+ * a copy of it owned by the presentation thread. The palette of
+ * the copy always follows the one of the window.
+ * @param src Frame to show.
+ * @param dst Display surface or its copy.
+ * @param palette Display palette.
+ * @param firstColor Offset of the first display color to update.
+ * @param numColors Amount of display colors to update.
+ * @param clearScreen Clear the window before drawing the frame.
+ */
+void Screen::present(SDL_Surface *src, SDL_Surface *dst, const SDL_Color *palette, int firstColor, int numColors, bool clearScreen)
+{
+	if (clearScreen)
+	{
+		Surface::CleanSdlSurface(dst);
+	}
+
 	// perform any requested palette update
-	if (_flickerFix && _pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
+	if (_flickerFix && numColors)
 	{
-		if (_screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, &(deferredPalette[_firstColor]), _firstColor, _numColors) == 0)
+		if (SDL_SetColors(dst, const_cast<SDL_Color*>(&palette[firstColor]), firstColor, numColors) == 0)
 		{
 			Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
 		}
-		_numColors = 0;
-		_pushPalette = false;
 	}
 
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
-		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
+		Zoom::flipWithZoom(src, dst, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
 	}
 	else
 	{
-		SDL_BlitSurface(_surface.get(), 0, _screen, 0);
+		SDL_BlitSurface(src, 0, dst, 0);
 	}
 
 	// perform any requested palette update
-	if (!_flickerFix && _pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
+	if (!_flickerFix && numColors)
 	{
-		if (_screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, &(deferredPalette[_firstColor]), _firstColor, _numColors) == 0)
+		if (SDL_SetColors(dst, const_cast<SDL_Color*>(&palette[firstColor]), firstColor, numColors) == 0)
 		{
 			Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
 		}
-		_numColors = 0;
-		_pushPalette = false;
 	}
+}
 
+/**
+ * Copies the frame the presentation thread has finished onto
+ * the game window, then flips it. Must run on the main thread
+ * while the presentation thread is idle.
+ */
+void Screen::showPresented()
+{
+	if (!_presentReady)
+	{
+		return;
+	}
+	_presentReady = false;
+
+	SDL_Color *palette = &_presentPalette[_presentFirstColor];
+	if (_flickerFix && _presentNumColors)
+	{
+		SDL_SetColors(_screen, palette, _presentFirstColor, _presentNumColors);
+	}
+
+	if (SDL_MUSTLOCK(_screen))
+	{
+		SDL_LockSurface(_screen);
+	}
+	size_t rowSize = _screen->w * _screen->format->BytesPerPixel;
+	for (int y = 0; y < _screen->h; ++y)
+	{
+		memcpy((Uint8*)_screen->pixels + y * _screen->pitch, (const Uint8*)_presentTarget->pixels + y * _presentTarget->pitch, rowSize);
+	}
+	if (SDL_MUSTLOCK(_screen))
+	{
+		SDL_UnlockSurface(_screen);
+	}
 
+	if (!_flickerFix && _presentNumColors)
+	{
+		SDL_SetColors(_screen, palette, _presentFirstColor, _presentNumColors);
+	}
 
 	if (SDL_Flip(_screen) == -1)
 	{
@@ -229,13 +361,190 @@ void Screen::flip()
 	}
 }
 
+/**
+ * Presents the frames handed over by flip() until the thread is stopped.
+ * @param screen Pointer to the screen.
+ * @return Always 0.
+ */
+int Screen::presentThread(void *screen)
+{
+	Screen *self = static_cast<Screen*>(screen);
+	SDL_LockMutex(self->_presentMutex);
+	while (true)
+	{
+		while (!self->_presentPending && !self->_presentQuit)
+		{
+			SDL_CondWait(self->_presentWake, self->_presentMutex);
+		}
+		if (!self->_presentPending)
+		{
+			break;
+		}
+		SDL_UnlockMutex(self->_presentMutex);
+
+		auto start = std::chrono::steady_clock::now();
+		std::string error;
+		try
+		{
+			self->present(self->_presentSurface.get(), self->_presentTarget.get(), self->_presentPalette, self->_presentFirstColor, self->_presentNumColors, self->_presentClear);
+		}
+		catch (std::exception &e)
+		{
+			error = e.what();
+		}
+		catch (...)
+		{
+			error = "Unknown error in presentation thread";
+		}
+		double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		SDL_LockMutex(self->_presentMutex);
+		self->_presentStats.frames++;
+		self->_presentStats.presentTime += time;
+		self->_presentStats.maxPresentTime = std::max(self->_presentStats.maxPresentTime, time);
+		if (!error.empty())
+		{
+			self->_presentError = error;
+		}
+		else
+		{
+			self->_presentReady = true;
+		}
+		self->_presentPending = false;
+		SDL_CondBroadcast(self->_presentDone);
+	}
+	SDL_UnlockMutex(self->_presentMutex);
+	return 0;
+}
+
+/**
+ * Starts the presentation thread, if the options and display allow it.
+ */
+void Screen::startPresentThread()
+{
+	if (_presentThread || !useThreadedFlip())
+	{
+		return;
+	}
+	// the thread scales into a copy of the window, only the main thread touches the display
+	_presentTarget = Surface::NewSdlSurface(SDL_CreateRGBSurface(SDL_SWSURFACE, _screen->w, _screen->h, _screen->format->BitsPerPixel,
+		_screen->format->Rmask, _screen->format->Gmask, _screen->format->Bmask, _screen->format->Amask));
+	if (!_presentTarget)
+	{
+		Log(LOG_WARNING) << "Failed to create presentation surface: " << SDL_GetError();
+		return;
+	}
+	if (_screen->format->palette)
+	{
+		SDL_SetColors(_presentTarget.get(), _screen->format->palette->colors, 0, _screen->format->palette->ncolors);
+	}
+	_presentMutex = SDL_CreateMutex();
+	_presentWake = SDL_CreateCond();
+	_presentDone = SDL_CreateCond();
+	_presentPending = false;
+	_presentReady = false;
+	_presentQuit = false;
+	_clearScreen = false;
+	_presentThread = SDL_CreateThread(presentThread, this);
+	if (_presentThread == 0)
+	{
+		Log(LOG_WARNING) << "Failed to create presentation thread: " << SDL_GetError();
+		stopPresentThread();
+	}
+}
+
+/**
+ * Lets the presentation thread finish the queued frame
+ * and waits for it to exit, so the display can be used directly.
+ */
+void Screen::stopPresentThread()
+{
+	if (_presentMutex == 0)
+	{
+		_presentTarget.reset();
+		return;
+	}
+	if (_presentThread)
+	{
+		SDL_LockMutex(_presentMutex);
+		_presentQuit = true;
+		SDL_CondSignal(_presentWake);
+		SDL_UnlockMutex(_presentMutex);
+		SDL_WaitThread(_presentThread, 0);
+		_presentThread = 0;
+	}
+	SDL_DestroyCond(_presentDone);
+	SDL_DestroyCond(_presentWake);
+	SDL_DestroyMutex(_presentMutex);
+	_presentDone = 0;
+	_presentWake = 0;
+	_presentMutex = 0;
+	try
+	{
+		showPresented();
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_WARNING) << "Failed to show the last frame: " << e.what();
+	}
+	_presentTarget.reset();
+	if (_clearScreen)
+	{
+		Surface::CleanSdlSurface(_screen);
+		_clearScreen = false;
+	}
+}
+
+/**
+ * Waits until the presentation thread is done with
+ * the queued frame, if there is one, and shows it.
+ */
+void Screen::finishPresent()
+{
+	if (_presentMutex == 0)
+	{
+		return;
+	}
+	SDL_LockMutex(_presentMutex);
+	while (_presentPending)
+	{
+		SDL_CondWait(_presentDone, _presentMutex);
+	}
+	SDL_UnlockMutex(_presentMutex);
+	showPresented();
+}
+
+/**
+ * Returns the frame pacing of the presentation thread.
+ * @return Timings of the presented frames.
+ */
+PresentStats Screen::getPresentStats() const
+{
+	if (_presentMutex == 0)
+	{
+		return _presentStats;
+	}
+	SDL_LockMutex(_presentMutex);
+	PresentStats stats = _presentStats;
+	SDL_UnlockMutex(_presentMutex);
+	return stats;
+}
+
 /**
  * Clears all the contents out of the internal buffer.
  */
 void Screen::clear()
 {
 	Surface::CleanSdlSurface(_surface.get());
-	Surface::CleanSdlSurface(_screen);
+	if (_presentThread)
+	{
+		// the presentation thread may be drawing, its copy of the window gets cleared with the next frame
+		_clearScreen = true;
+	}
+	else
+	{
+		Surface::CleanSdlSurface(_screen);
+	}
 }
 
 /**
@@ -264,11 +573,20 @@ void Screen::setPalette(const SDL_Color* colors, int firstcolor, int ncolors, bo
 
 	SDL_SetColors(_surface.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
 
+	if (immediately)
+	{
+		finishPresent();
+	}
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, const_cast<SDL_Color *>(colors), firstcolor, ncolors) == 0)
 	{
 		Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
 	}
+	if (immediately && _presentTarget && _presentTarget->format->palette)
+	{
+		// keep the presentation thread's copy of the window in sync
+		SDL_SetColors(_presentTarget.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
+	}
 
 	// Sanity check
 	/*
@@ -327,6 +645,7 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 #ifdef __linux__
 	Uint32 oldFlags = _flags;
 #endif
+	stopPresentThread();
 	makeVideoFlags();
 
 	if (!_surface || (_surface->format->BitsPerPixel != _bpp ||
@@ -492,6 +811,8 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 	{
 		setPalette(getPalette());
 	}
+
+	startPresentThread();
 }
 
 /**
@@ -534,8 +855,9 @@ int Screen::getCursorLeftBlackBand() const
  * Saves a screenshot of the screen's contents.
  * @param filename Filename of the PNG file.
  */
-void Screen::screenshot(const std::string &filename) const
+void Screen::screenshot(const std::string &filename)
 {
+	finishPresent();
 	SDL_Surface *screenshot = SDL_AllocSurface(0, getWidth() - getWidth()%4, getHeight(), 24, 0xff, 0xff00, 0xff0000, 0);
 
 	if (useOpenGL())
@@ -635,6 +957,21 @@ bool Screen::useOpenGL()
 #endif
 }
 
+/**
+ * Check if frames are scaled and flipped on a separate thread.
+ * @return if it is enabled.
+ */
+bool Screen::useThreadedFlip()
+{
+#ifdef __APPLE__
+	// the window can only be touched from the main thread
+	return false;
+#else
+	// the OpenGL context belongs to the main thread
+	return Options::oxceThreadedFlip && !useOpenGL();
+#endif
+}
+
 /**
  * Gets the Horizontal offset from the mid-point of the screen, in pixels.
  * @return the horizontal offset.
@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <SDL.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
 #include <string>
 #include "OpenGL.h"
 #include "Surface.h"
@@ -28,6 +30,19 @@ namespace OpenXcom
 class Surface;
 class Action;
 
+/**
+ * Frame pacing of the presentation thread, times in microseconds.
+ */
+struct PresentStats
+{
+	/// Frames presented so far.
+	int frames;
+	/// Total and longest time spent converting, scaling and flipping a frame.
+	double presentTime, maxPresentTime;
+	/// Total time the game waited for the previous frame to be presented.
+	double waitTime;
+};
+
 /**
  * A display screen, handles rendering onto the game window.
  * In SDL a Screen is treated like a Surface, so this is just
@@ -52,8 +67,30 @@ private:
 	OpenGL glOutput;
 	Surface::UniqueBufferPtr _buffer;
 	Surface::UniqueSurfacePtr _surface;
+	SDL_Thread *_presentThread;
+	SDL_mutex *_presentMutex;
+	SDL_cond *_presentWake, *_presentDone;
+	Surface::UniqueBufferPtr _presentBuffer;
+	Surface::UniqueSurfacePtr _presentSurface, _presentTarget;
+	SDL_Color _presentPalette[256];
+	int _presentNumColors, _presentFirstColor;
+	bool _presentPending, _presentReady, _presentClear, _clearScreen, _presentQuit;
+	std::string _presentError;
+	PresentStats _presentStats;
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
+	/// Converts and scales a finished frame into a display surface.
+	void present(SDL_Surface *src, SDL_Surface *dst, const SDL_Color *palette, int firstColor, int numColors, bool clearScreen);
+	/// Puts the frame prepared by the presentation thread on the game window.
+	void showPresented();
+	/// Starts the presentation thread if it's enabled.
+	void startPresentThread();
+	/// Stops the presentation thread.
+	void stopPresentThread();
+	/// Waits until the presentation thread is done with the last frame and shows it.
+	void finishPresent();
+	/// Entry point of the presentation thread.
+	static int presentThread(void *screen);
 public:
 	static const int ORIGINAL_WIDTH;
 	static const int ORIGINAL_HEIGHT;
@@ -93,11 +130,15 @@ public:
 	/// Gets the screen's left black forbidden to cursor band's width.
 	int getCursorLeftBlackBand() const;
 	/// Takes a screenshot.
-	void screenshot(const std::string &filename) const;
+	void screenshot(const std::string &filename);
+	/// Gets the frame pacing of the presentation thread.
+	PresentStats getPresentStats() const;
 	/// Checks whether a 32bit scaler is requested and works for the selected resolution
 	static bool use32bitScaler();
 	/// Checks whether OpenGL output is requested
 	static bool useOpenGL();
+	/// Checks whether frames are presented on a separate thread.
+	static bool useThreadedFlip();
 	/// update the game scale as required.
 	static void updateScale(int type, int &width, int &height, bool change);
 };
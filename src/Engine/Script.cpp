@@ -24,6 +24,7 @@
 #include <cmath>
 #include <bitset>
 #include <array>
+#include <chrono>
 
 #include "Logger.h"
 #include "Options.h"
@@ -33,6 +34,7 @@
 #include "ShaderDraw.h"
 #include "ShaderMove.h"
 #include "Exception.h"
+#include "ScriptProfiler.h"
 #include "../fallthrough.h"
 
 namespace OpenXcom
@@ -43,26 +45,24 @@ namespace OpenXcom
 ////////////////////////////////////////////////////////////
 #define MACRO_QUOTE(...) __VA_ARGS__
 
-#define MACRO_COPY_4(Func, Pos) \
-	Func((Pos) + 0x0) \
-	Func((Pos) + 0x1) \
-	Func((Pos) + 0x2) \
-	Func((Pos) + 0x3)
-#define MACRO_COPY_16(Func, Pos) \
-	MACRO_COPY_4(Func, (Pos) + 0x00) \
-	MACRO_COPY_4(Func, (Pos) + 0x04) \
-	MACRO_COPY_4(Func, (Pos) + 0x08) \
-	MACRO_COPY_4(Func, (Pos) + 0x0C)
-#define MACRO_COPY_64(Func, Pos) \
-	MACRO_COPY_16(Func, (Pos) + 0x00) \
-	MACRO_COPY_16(Func, (Pos) + 0x10) \
-	MACRO_COPY_16(Func, (Pos) + 0x20) \
-	MACRO_COPY_16(Func, (Pos) + 0x30)
-#define MACRO_COPY_256(Func, Pos) \
-	MACRO_COPY_64(Func, (Pos) + 0x00) \
-	MACRO_COPY_64(Func, (Pos) + 0x40) \
-	MACRO_COPY_64(Func, (Pos) + 0x80) \
-	MACRO_COPY_64(Func, (Pos) + 0xC0)
+#define MACRO_COPY_HEX_16(Func, High) \
+	Func(High##0) Func(High##1) Func(High##2) Func(High##3) \
+	Func(High##4) Func(High##5) Func(High##6) Func(High##7) \
+	Func(High##8) Func(High##9) Func(High##A) Func(High##B) \
+	Func(High##C) Func(High##D) Func(High##E) Func(High##F)
+#define MACRO_COPY_HEX_256(Func) \
+	MACRO_COPY_HEX_16(Func, 0x0) MACRO_COPY_HEX_16(Func, 0x1) MACRO_COPY_HEX_16(Func, 0x2) MACRO_COPY_HEX_16(Func, 0x3) \
+	MACRO_COPY_HEX_16(Func, 0x4) MACRO_COPY_HEX_16(Func, 0x5) MACRO_COPY_HEX_16(Func, 0x6) MACRO_COPY_HEX_16(Func, 0x7) \
+	MACRO_COPY_HEX_16(Func, 0x8) MACRO_COPY_HEX_16(Func, 0x9) MACRO_COPY_HEX_16(Func, 0xA) MACRO_COPY_HEX_16(Func, 0xB) \
+	MACRO_COPY_HEX_16(Func, 0xC) MACRO_COPY_HEX_16(Func, 0xD) MACRO_COPY_HEX_16(Func, 0xE) MACRO_COPY_HEX_16(Func, 0xF)
+
+/**
+ * GCC and Clang can jump straight to the next operation using label addresses,
+ * define OXCE_SCRIPT_NO_COMPUTED_GOTO to fall back to the portable `switch` dispatch.
+ */
+#if defined(__GNUC__) && !defined(OXCE_SCRIPT_NO_COMPUTED_GOTO)
+#define OXCE_SCRIPT_COMPUTED_GOTO
+#endif
 
 
 ////////////////////////////////////////////////////////////
@@ -231,6 +231,85 @@ static inline RetEnum bit_popcount_h(int& reg)
 	IMPL(call,			MACRO_QUOTE({ return call_func_h(c, func, d, p);								}),		(ScriptFunc func, const Uint8* d, ScriptWorkerBase& c, ProgPos& p),		"") \
 
 
+/**
+ * Int argument of fused operation, value is read only after first part of operation is done,
+ * because the function called there can overwrite the register.
+ */
+struct ScriptFusedInt
+{
+	const int* reg;
+	int value;
+
+	[[gnu::always_inline]]
+	int get() const
+	{
+		return reg ? *reg : value;
+	}
+};
+
+namespace helper
+{
+
+struct ArgFusedRegDef
+{
+	using ReturnType = ScriptFusedInt;
+	static constexpr size_t size = sizeof(Uint8);
+	static ReturnType get(ScriptWorkerBase& sw, const Uint8* arg, ProgPos& curr)
+	{
+		return { &sw.ref<ScriptInt>(*arg), 0 };
+	}
+
+	static bool parse(ParserWriter& ph, const ScriptRefData& t)
+	{
+		return false;
+	}
+
+	static ArgEnum type()
+	{
+		return ArgInvalid;
+	}
+};
+
+struct ArgFusedValueDef
+{
+	using ReturnType = ScriptFusedInt;
+	static constexpr size_t size = sizeof(ScriptInt);
+	static ReturnType get(ScriptWorkerBase& sw, const Uint8* arg, ProgPos& curr)
+	{
+		return { nullptr, sw.const_val<ScriptInt>(arg) };
+	}
+
+	static bool parse(ParserWriter& ph, const ScriptRefData& t)
+	{
+		return false;
+	}
+
+	static ArgEnum type()
+	{
+		return ArgInvalid;
+	}
+};
+
+template<>
+struct ArgSelector<ScriptFusedInt>
+{
+	using type = Arg<ArgFusedValueDef, ArgFusedRegDef>;
+};
+
+} //namespace helper
+
+/**
+ * Operations created by the optimizer from a function call and the operation that follows it,
+ * scripts can't use them directly. Arguments are the ones of `call` followed by the ones of the second operation.
+ * @param IMPL macro function that access data. Take 3 args: Name, definition of operation and declaration of it's arguments.
+ */
+#define MACRO_PROC_FUSED_DEFINITION(IMPL) \
+	/*	Name,			Implementation,																																		Args,					Description */ \
+	IMPL(call_add,		MACRO_QUOTE({ const auto r = call_func_h(c, func, d, p); if (r != RetContinue) return r; Reg0 += Data1.get();							return RetContinue; }),		(ScriptFunc func, const Uint8* d, ScriptWorkerBase& c, ProgPos& p, int& Reg0, ScriptFusedInt Data1),	"") \
+	IMPL(call_test_le,	MACRO_QUOTE({ const auto r = call_func_h(c, func, d, p); if (r != RetContinue) return r; Prog = (A.get() <= B.get()) ? LabelTrue : LabelFalse;	return RetContinue; }),		(ScriptFunc func, const Uint8* d, ScriptWorkerBase& c, ProgPos& p, ProgPos& Prog, ScriptFusedInt A, ScriptFusedInt B, ProgPos LabelTrue, ProgPos LabelFalse),	"") \
+	IMPL(call_test_eq,	MACRO_QUOTE({ const auto r = call_func_h(c, func, d, p); if (r != RetContinue) return r; Prog = (A.get() == B.get()) ? LabelTrue : LabelFalse;	return RetContinue; }),		(ScriptFunc func, const Uint8* d, ScriptWorkerBase& c, ProgPos& p, ProgPos& Prog, ScriptFusedInt A, ScriptFusedInt B, ProgPos LabelTrue, ProgPos LabelFalse),	"") \
+
+
 ////////////////////////////////////////////////////////////
 //					function definition
 ////////////////////////////////////////////////////////////
@@ -255,6 +334,7 @@ namespace
 	};
 
 MACRO_PROC_DEFINITION(MACRO_CREATE_FUNC)
+MACRO_PROC_FUSED_DEFINITION(MACRO_CREATE_FUNC)
 
 #undef MACRO_CREATE_FUNC
 
@@ -370,11 +450,24 @@ struct Func_test_eq_text
 enum ProcEnum : Uint8
 {
 	MACRO_PROC_DEFINITION(MACRO_CREATE_PROC_ENUM)
+	MACRO_PROC_FUSED_DEFINITION(MACRO_CREATE_PROC_ENUM)
 	Proc_EnumMax,
 };
 
 #undef MACRO_CREATE_PROC_ENUM
 
+/**
+ * Macro used for creating list of all versions of all operations
+ */
+#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+
+/**
+ * List of all versions of operations, position on list is equal to operation id.
+ */
+using ProcFuncList = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY) MACRO_PROC_FUSED_DEFINITION(MACRO_FUNC_ARRAY));
+
+#undef MACRO_FUNC_ARRAY
+
 ////////////////////////////////////////////////////////////
 //					core loop function
 ////////////////////////////////////////////////////////////
@@ -382,19 +475,29 @@ enum ProcEnum : Uint8
 /**
  * Core function in script engine used to executing scripts
  * @param proc array storing operation of script
+ * @param opCount if CountOps is set, number of executed operations is added there.
  * @return Result of executing script
  */
-static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
+template<bool CountOps = false>
+static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc, Uint64* opCount = nullptr)
 {
 	ProgPos curr = ProgPos::Start;
 	//--------------------------------------------------
 	//			helper macros for this function
 	//--------------------------------------------------
-	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+#ifdef OXCE_SCRIPT_COMPUTED_GOTO
+	#define MACRO_PROC_LABEL(POS) procLabel_##POS:
+	#define MACRO_PROC_NEXT() goto *procLabels[proc[(int)curr++]]
+	#define MACRO_PROC_ADDRESS(POS) &&procLabel_##POS,
+#else
+	#define MACRO_PROC_LABEL(POS) case (POS):
+	#define MACRO_PROC_NEXT() continue
+#endif
 	#define MACRO_FUNC_ARRAY_LOOP(POS) \
-		case (POS): \
+		MACRO_PROC_LABEL(POS) \
 		{ \
-			using currType = helper::GetType<func, POS>; \
+			using currType = helper::GetType<ProcFuncList, POS>; \
+			if constexpr (CountOps) ++*opCount; \
 			const auto p = proc + (int)curr; \
 			curr += currType::offset; \
 			const auto ret = currType::func(data, p, curr); \
@@ -409,25 +512,37 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 				} \
 			} \
 			else \
-				continue; \
+				MACRO_PROC_NEXT(); \
 		}
 	//--------------------------------------------------
 
-	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+#ifdef OXCE_SCRIPT_COMPUTED_GOTO
+	static const void* const procLabels[256] =
+	{
+		MACRO_COPY_HEX_256(MACRO_PROC_ADDRESS)
+	};
 
+	MACRO_PROC_NEXT();
+	MACRO_COPY_HEX_256(MACRO_FUNC_ARRAY_LOOP)
+#else
 	while (true)
 	{
 		switch (proc[(int)curr++])
 		{
-		MACRO_COPY_256(MACRO_FUNC_ARRAY_LOOP, 0)
+		MACRO_COPY_HEX_256(MACRO_FUNC_ARRAY_LOOP)
 		}
 	}
+#endif
 
 	//--------------------------------------------------
 	//			removing helper macros
 	//--------------------------------------------------
 	#undef MACRO_FUNC_ARRAY_LOOP
-	#undef MACRO_FUNC_ARRAY
+	#undef MACRO_PROC_LABEL
+	#undef MACRO_PROC_NEXT
+#ifdef OXCE_SCRIPT_COMPUTED_GOTO
+	#undef MACRO_PROC_ADDRESS
+#endif
 	//--------------------------------------------------
 
 	errorLabel:
@@ -452,6 +567,8 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 }
 /**
  * Blitting one surface to another using script.
+ * Scripts that do not read the destination pixel are run at most
+ * once per source color, other pixels reuse the result.
  * @param src source surface.
  * @param dest destination surface.
  * @param x x offset of source surface.
@@ -466,37 +583,49 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 	if (_proc)
 	{
-		if (_events)
+		auto run = [&](const Uint8& srcStuff, const Uint8& destStuff)
+		{
+			ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
+			set(arg);
+			if (_events)
+			{
+				auto ptr = _events;
+				while (*ptr)
+				{
+					reset(arg);
+					executeBase(ptr->data(), ptr->getProfile());
+					++ptr;
+				}
+				++ptr;
+
+				reset(arg);
+				executeBase(_proc, _profile);
+
+				while (*ptr)
+				{
+					reset(arg);
+					executeBase(ptr->data(), ptr->getProfile());
+					++ptr;
+				}
+				++ptr;
+			}
+			else
+			{
+				executeBase(_proc, _profile);
+			}
+			get(arg);
+			return arg.getFirst();
+		};
+
+		if (_destUsed)
 		{
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						auto ptr = _events;
-						while (*ptr)
-						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
-						}
-						++ptr;
-
-						reset(arg);
-						scriptExe(*this, _proc);
-
-						while (*ptr)
-						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
-						}
-						++ptr;
-
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						int result = run(srcStuff, destStuff);
+						if (result) destStuff = result;
 					}
 				},
 				destShader,
@@ -505,16 +634,21 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 		}
 		else
 		{
+			// result depends only on the source color and arguments fixed for the whole blit,
+			// so the script runs once for every color used by the sprite and the rest is a lookup
+			int lut[256];
+			bool known[256] = { };
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						scriptExe(*this, _proc);
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						if (!known[srcStuff])
+						{
+							lut[srcStuff] = run(srcStuff, destStuff);
+							known[srcStuff] = true;
+						}
+						if (lut[srcStuff]) destStuff = lut[srcStuff];
 					}
 				},
 				destShader,
@@ -530,13 +664,34 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 /**
  * Execute script with two arguments.
+ * @param proc script operations.
+ * @param profile counters of script, when it is profiled.
  * @return Result value from script.
  */
-void ScriptWorkerBase::executeBase(const Uint8* proc)
+void ScriptWorkerBase::executeBase(const Uint8* proc, ScriptProfileEntry* profile)
 {
 	if (proc)
 	{
-		scriptExe(*this, proc);
+		if (profile)
+		{
+			Uint64 ops = 0;
+			const auto start = std::chrono::steady_clock::now();
+			scriptExe<true>(*this, proc, &ops);
+			const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			ScriptProfiler::add(profile, ops, time);
+			if (op_counter)
+			{
+				*op_counter += ops;
+			}
+		}
+		else if (op_counter)
+		{
+			scriptExe<true>(*this, proc, op_counter);
+		}
+		else
+		{
+			scriptExe(*this, proc);
+		}
 	}
 }
 
@@ -1744,6 +1899,302 @@ SelectedToken ScriptRefTokens::getNextToken(TokenEnum excepted)
 	return SelectedToken{ type, ScriptRef{ begin, end } };
 }
 
+////////////////////////////////////////////////////////////
+//					Optimizer helpers
+////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/**
+ * How operation use one of its arguments.
+ */
+enum ProcArgKind : Uint8
+{
+	ProcArgNone,
+	ProcArgIntRead,
+	ProcArgIntWrite,
+	ProcArgRegRead,
+	ProcArgRegWrite,
+	ProcArgIntConst,
+	ProcArgLabel,
+	ProcArgData,
+};
+
+/**
+ * Max number of arguments of one operation.
+ */
+constexpr int ProcArgMax = 10;
+
+template<typename T>
+struct ProcArgKindOf
+{
+	static constexpr ProcArgKind value = ProcArgData;
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgContextDef>
+{
+	static constexpr ProcArgKind value = ProcArgNone;
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgProgDef>
+{
+	static constexpr ProcArgKind value = ProcArgNone;
+};
+
+template<typename T>
+struct ProcArgKindOf<helper::ArgNullDef<T>>
+{
+	static constexpr ProcArgKind value = ProcArgNone;
+};
+
+template<typename T>
+struct ProcArgKindOf<helper::ArgRegDef<T>>
+{
+	static constexpr bool isInt = std::is_same<std::decay_t<T>, ScriptInt>::value;
+	static constexpr bool isWrite = std::is_reference<T>::value && !std::is_const<std::remove_reference_t<T>>::value;
+	static constexpr ProcArgKind value = isInt ? (isWrite ? ProcArgIntWrite : ProcArgIntRead) : (isWrite ? ProcArgRegWrite : ProcArgRegRead);
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgValueDef<ScriptInt>>
+{
+	static constexpr ProcArgKind value = ProcArgIntConst;
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgLabelDef>
+{
+	static constexpr ProcArgKind value = ProcArgLabel;
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgFusedRegDef>
+{
+	static constexpr ProcArgKind value = ProcArgIntRead;
+};
+
+template<>
+struct ProcArgKindOf<helper::ArgFusedValueDef>
+{
+	static constexpr ProcArgKind value = ProcArgIntConst;
+};
+
+/**
+ * Layout of one version of operation in proc vector.
+ */
+struct ProcInfo
+{
+	/// Id of first version of this operation, negative for unused ids.
+	int base = -1;
+	/// Size of all arguments.
+	int size = 0;
+	/// Number of arguments that are stored in proc vector.
+	int argsSize = 0;
+	/// How arguments are used.
+	ProcArgKind argKind[ProcArgMax] = { };
+	/// Offsets of arguments after operation id.
+	int argOffset[ProcArgMax] = { };
+	/// Sizes of arguments.
+	int argSize[ProcArgMax] = { };
+
+	/// Add next argument.
+	void addArg(ProcArgKind kind, int offset, int s)
+	{
+		if (kind != ProcArgNone)
+		{
+			argKind[argsSize] = kind;
+			argOffset[argsSize] = offset;
+			argSize[argsSize] = s;
+			++argsSize;
+		}
+	}
+};
+
+template<typename T>
+struct ProcInfoFill;
+
+template<typename Func, int Ver, int... Pos>
+struct ProcInfoFill<helper::FuncVer<Func, Ver, helper::ListTag<Pos...>>>
+{
+	using V = helper::FuncVer<Func, Ver, helper::ListTag<Pos...>>;
+
+	static_assert(sizeof...(Pos) <= ProcArgMax, "Too many arguments in script operation");
+
+	static void fill(ProcInfo& info)
+	{
+		info.size = V::offset;
+		(info.addArg(ProcArgKindOf<typename V::template GetTypeAt<Pos>>::value, V::Args::offset(Ver, Pos), V::template GetTypeAt<Pos>::size), ...);
+	}
+};
+
+template<typename... V>
+void procInfoFill(std::array<ProcInfo, 256>& table, helper::SumList<V...>)
+{
+	size_t i = 0;
+	(ProcInfoFill<V>::fill(table[i++]), ...);
+}
+
+/**
+ * Get layout of all operations.
+ */
+const std::array<ProcInfo, 256>& getProcInfo()
+{
+	static const std::array<ProcInfo, 256> table = []
+	{
+		std::array<ProcInfo, 256> t = { };
+		procInfoFill(t, ProcFuncList{});
+
+#define MACRO_PROC_INFO_BASE(NAME, ...) \
+		for (int i = MACRO_PROC_ID(NAME); i <= Proc_##NAME##_end; ++i) t[i].base = MACRO_PROC_ID(NAME);
+
+		MACRO_PROC_DEFINITION(MACRO_PROC_INFO_BASE)
+		MACRO_PROC_FUSED_DEFINITION(MACRO_PROC_INFO_BASE)
+
+#undef MACRO_PROC_INFO_BASE
+
+		return t;
+	}();
+	return table;
+}
+
+/**
+ * Operation that never continue to next one.
+ */
+bool isProcTerminator(int base)
+{
+	return base == Proc_exit || base == Proc_goto || base == Proc_test_le || base == Proc_test_eq || base == Proc_call_test_le || base == Proc_call_test_eq;
+}
+
+/**
+ * Operation that can stop script with error.
+ */
+bool isProcFallible(int base)
+{
+	return base == Proc_div || base == Proc_mod || base == Proc_muldiv || base == Proc_offsetmod ||
+		base == Proc_wavegen_rect || base == Proc_wavegen_saw || base == Proc_wavegen_tri;
+}
+
+/**
+ * Operation that can be folded when both arguments are known.
+ */
+bool isProcFoldable(int base)
+{
+	return base == Proc_add || base == Proc_sub || base == Proc_mul || base == Proc_bit_and || base == Proc_bit_or || base == Proc_bit_xor;
+}
+
+/**
+ * Calculate result of foldable operation, using same overflow behavior as script engine.
+ */
+ScriptInt foldProc(int base, ScriptInt a, ScriptInt b)
+{
+	const auto ua = static_cast<unsigned>(a);
+	const auto ub = static_cast<unsigned>(b);
+	switch (base)
+	{
+	case Proc_add: return static_cast<ScriptInt>(ua + ub);
+	case Proc_sub: return static_cast<ScriptInt>(ua - ub);
+	case Proc_mul: return static_cast<ScriptInt>(ua * ub);
+	case Proc_bit_and: return a & b;
+	case Proc_bit_or: return a | b;
+	case Proc_bit_xor: return a ^ b;
+	default: return a;
+	}
+}
+
+/**
+ * Foldable operation that do not change its first argument.
+ */
+bool isProcIdentity(int base, ScriptInt b)
+{
+	switch (base)
+	{
+	case Proc_add: case Proc_sub: case Proc_bit_or: case Proc_bit_xor: return b == 0;
+	case Proc_mul: return b == 1;
+	case Proc_bit_and: return b == -1;
+	default: return false;
+	}
+}
+
+/**
+ * Argument of operation decoded by optimizer.
+ */
+struct OptArg
+{
+	/// How argument is used.
+	ProcArgKind kind;
+	/// Register offset, int value or label index.
+	ScriptInt value;
+	/// Position in original proc vector.
+	size_t pos;
+	/// Size in proc vector.
+	int size;
+};
+
+/**
+ * Operation decoded by optimizer.
+ */
+struct OptProc
+{
+	/// Position in original proc vector.
+	size_t pos;
+	/// Current operation id.
+	int id;
+	/// Operation was removed from script.
+	bool removed;
+	/// Some label point to this operation.
+	bool target;
+	/// Number of arguments.
+	int argsSize;
+	/// Arguments stored in proc vector.
+	OptArg args[ProcArgMax];
+};
+
+/**
+ * Replace operation by version of other one that accept given arguments.
+ * @return False if there is no matching version.
+ */
+bool rebuildProc(OptProc& op, int base, const OptArg* args, int argsSize)
+{
+	const auto& info = getProcInfo();
+	OptArg copy[ProcArgMax];
+	std::copy(args, args + argsSize, copy);
+
+	for (int id = base; id < 256 && info[id].base == base; ++id)
+	{
+		const auto& curr = info[id];
+		if (curr.argsSize != argsSize)
+		{
+			continue;
+		}
+		bool match = true;
+		for (int a = 0; a < argsSize; ++a)
+		{
+			if (curr.argKind[a] != copy[a].kind || (copy[a].kind == ProcArgData && curr.argSize[a] != copy[a].size))
+			{
+				match = false;
+				break;
+			}
+		}
+		if (match)
+		{
+			op.id = id;
+			op.argsSize = argsSize;
+			for (int a = 0; a < argsSize; ++a)
+			{
+				op.args[a] = copy[a];
+				op.args[a].size = curr.argSize[a];
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+} //namespace
+
 ////////////////////////////////////////////////////////////
 //					ParserWriter class
 ////////////////////////////////////////////////////////////
@@ -1773,6 +2224,10 @@ ParserWriter::ParserWriter(
 void ParserWriter::relese()
 {
 	pushProc(Proc_exit);
+	if (Options::oxceScriptOptimizer)
+	{
+		optimize();
+	}
 	refLabels.forEachPosition(
 		[&](auto pos, ProgPos value)
 		{
@@ -1840,6 +2295,527 @@ void ParserWriter::relese()
 	);
 }
 
+/**
+ * Simplify operations in proc vector, called before labels and texts are written to it.
+ * It fold constants, remove dead stores and unreachable code, thread jumps
+ * and fuse function calls with the operations that use their results.
+ */
+void ParserWriter::optimize()
+{
+	using LabelRef = decltype(refLabels.positions)::value_type::second_type;
+	using TextRef = decltype(refTexts.positions)::value_type::second_type;
+
+	auto& proc = container._proc;
+	const auto& info = getProcInfo();
+
+	// where labels and texts are used in proc vector
+	std::map<size_t, size_t> labelUses;
+	for (auto& p : refLabels.positions)
+	{
+		labelUses[static_cast<size_t>(p.first.getPos())] = static_cast<size_t>(p.second);
+	}
+	std::map<size_t, size_t> textUses;
+	for (auto& p : refTexts.positions)
+	{
+		textUses[static_cast<size_t>(p.first.getPos())] = static_cast<size_t>(p.second);
+	}
+
+	// decode all operations, anything unexpected leave script unchanged
+	std::vector<OptProc> ops;
+	std::vector<int> opIndex(proc.size(), -1);
+	for (size_t pos = 0; pos < proc.size(); )
+	{
+		const auto& curr = info[proc[pos]];
+		if (curr.base < 0 || pos + 1 + curr.size > proc.size())
+		{
+			return;
+		}
+		OptProc op = { };
+		op.pos = pos;
+		op.id = proc[pos];
+		op.argsSize = curr.argsSize;
+		for (int a = 0; a < curr.argsSize; ++a)
+		{
+			auto& arg = op.args[a];
+			arg.kind = curr.argKind[a];
+			arg.pos = pos + 1 + curr.argOffset[a];
+			arg.size = curr.argSize[a];
+			if (arg.kind == ProcArgIntConst)
+			{
+				memcpy(&arg.value, &proc[arg.pos], sizeof(ScriptInt));
+			}
+			else if (arg.kind == ProcArgLabel)
+			{
+				auto it = labelUses.find(arg.pos);
+				if (it == labelUses.end())
+				{
+					return;
+				}
+				arg.value = static_cast<ScriptInt>(it->second);
+			}
+			else if (arg.kind != ProcArgData)
+			{
+				arg.value = proc[arg.pos];
+			}
+		}
+		opIndex[pos] = static_cast<int>(ops.size());
+		ops.push_back(op);
+		pos += 1 + curr.size;
+	}
+	if (ops.empty())
+	{
+		return;
+	}
+
+	std::vector<int> labelOp(refLabels.values.size(), -1);
+	for (size_t l = 0; l < labelOp.size(); ++l)
+	{
+		const auto v = static_cast<size_t>(refLabels.values[l]);
+		if (v < proc.size())
+		{
+			labelOp[l] = opIndex[v];
+		}
+	}
+	for (auto& u : labelUses)
+	{
+		if (labelOp[u.second] < 0)
+		{
+			return;
+		}
+	}
+
+	// last operation is final `exit` and it is never removed
+	const int last = static_cast<int>(ops.size()) - 1;
+	auto baseOf = [&](const OptProc& op)
+	{
+		return info[op.id].base;
+	};
+	auto live = [&](int i)
+	{
+		while (ops[i].removed)
+		{
+			++i;
+		}
+		return i;
+	};
+	auto nextLive = [&](int i)
+	{
+		return i < last ? live(i + 1) : -1;
+	};
+	auto labelTarget = [&](ScriptInt l)
+	{
+		return live(labelOp[l]);
+	};
+	auto hasData = [&](const OptProc& op)
+	{
+		for (int a = 0; a < op.argsSize; ++a)
+		{
+			if (op.args[a].kind == ProcArgData)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	auto forEachDataLabel = [&](const OptProc& op, auto&& f)
+	{
+		for (int a = 0; a < op.argsSize; ++a)
+		{
+			const auto& arg = op.args[a];
+			if (arg.kind == ProcArgData)
+			{
+				for (auto it = labelUses.lower_bound(arg.pos); it != labelUses.end() && it->first < arg.pos + arg.size; ++it)
+				{
+					f(static_cast<ScriptInt>(it->second));
+				}
+			}
+		}
+	};
+	auto usesReg = [&](const OptProc& op, ScriptInt reg)
+	{
+		for (int a = 0; a < op.argsSize; ++a)
+		{
+			const auto& arg = op.args[a];
+			if ((arg.kind == ProcArgIntRead || arg.kind == ProcArgIntWrite) && arg.value == reg)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	auto isPureStore = [&](const OptProc& op)
+	{
+		const auto base = baseOf(op);
+		return base == Proc_clear || (base == Proc_set && op.args[1].kind == ProcArgIntConst);
+	};
+	auto updateTargets = [&]
+	{
+		for (auto& op : ops)
+		{
+			op.target = false;
+		}
+		for (auto& op : ops)
+		{
+			if (op.removed)
+			{
+				continue;
+			}
+			for (int a = 0; a < op.argsSize; ++a)
+			{
+				if (op.args[a].kind == ProcArgLabel)
+				{
+					ops[labelTarget(op.args[a].value)].target = true;
+				}
+			}
+			forEachDataLabel(op, [&](ScriptInt l) { ops[labelTarget(l)].target = true; });
+		}
+	};
+
+	// jumps to jumps go directly to final destination
+	auto threadJumps = [&]
+	{
+		bool changed = false;
+		for (int i = 0; i < last; ++i)
+		{
+			auto& op = ops[i];
+			if (op.removed || !isProcTerminator(baseOf(op)))
+			{
+				continue;
+			}
+			for (int a = 0; a < op.argsSize; ++a)
+			{
+				auto& arg = op.args[a];
+				if (arg.kind != ProcArgLabel)
+				{
+					continue;
+				}
+				const auto start = arg.value;
+				for (size_t guard = 0; guard < ops.size(); ++guard)
+				{
+					const auto& dest = ops[labelTarget(arg.value)];
+					if (baseOf(dest) != Proc_goto || dest.args[0].value == arg.value)
+					{
+						break;
+					}
+					arg.value = dest.args[0].value;
+				}
+				changed |= arg.value != start;
+			}
+			const auto base = baseOf(op);
+			if (base == Proc_goto && baseOf(ops[labelTarget(op.args[0].value)]) == Proc_exit)
+			{
+				changed |= rebuildProc(op, Proc_exit, nullptr, 0);
+			}
+			else if ((base == Proc_test_le || base == Proc_test_eq) && labelTarget(op.args[2].value) == labelTarget(op.args[3].value))
+			{
+				changed |= rebuildProc(op, Proc_goto, &op.args[2], 1);
+			}
+		}
+		return changed;
+	};
+
+	// propagate known values of int registers in straight code
+	auto foldConstants = [&]
+	{
+		bool changed = false;
+		std::array<ScriptInt, 256> values = { };
+		std::bitset<256> known;
+
+		updateTargets();
+		for (int i = 0; i <= last; ++i)
+		{
+			auto& op = ops[i];
+			if (op.removed)
+			{
+				continue;
+			}
+			if (op.target)
+			{
+				known.reset();
+			}
+
+			const bool call = hasData(op);
+			if (!call)
+			{
+				for (int a = 0; a < op.argsSize; ++a)
+				{
+					const auto& arg = op.args[a];
+					if (arg.kind == ProcArgIntRead && known[arg.value])
+					{
+						OptArg args[ProcArgMax];
+						std::copy(op.args, op.args + op.argsSize, args);
+						args[a].kind = ProcArgIntConst;
+						args[a].value = values[arg.value];
+						changed |= rebuildProc(op, baseOf(op), args, op.argsSize);
+					}
+				}
+			}
+
+			const auto base = baseOf(op);
+			if (base == Proc_set && op.args[1].kind == ProcArgIntRead && op.args[0].value == op.args[1].value)
+			{
+				op.removed = true;
+				changed = true;
+				continue;
+			}
+			if (isProcFoldable(base) && op.args[1].kind == ProcArgIntConst)
+			{
+				const auto reg = op.args[0].value;
+				const auto value = op.args[1].value;
+				if (isProcIdentity(base, value))
+				{
+					op.removed = true;
+					changed = true;
+					continue;
+				}
+				if (known[reg])
+				{
+					const OptArg args[] =
+					{
+						op.args[0],
+						OptArg{ ProcArgIntConst, foldProc(base, values[reg], value), 0, sizeof(ScriptInt) },
+					};
+					changed |= rebuildProc(op, Proc_set, args, 2);
+				}
+			}
+			else if ((base == Proc_test_le || base == Proc_test_eq) && op.args[0].kind == ProcArgIntConst && op.args[1].kind == ProcArgIntConst)
+			{
+				const bool result = base == Proc_test_le ? op.args[0].value <= op.args[1].value : op.args[0].value == op.args[1].value;
+				changed |= rebuildProc(op, Proc_goto, &op.args[result ? 2 : 3], 1);
+			}
+
+			// track values written by this operation
+			if (isPureStore(op))
+			{
+				const auto reg = op.args[0].value;
+				known.set(reg);
+				values[reg] = baseOf(op) == Proc_clear ? 0 : op.args[1].value;
+			}
+			else if (call || isProcTerminator(baseOf(op)))
+			{
+				known.reset();
+			}
+			else
+			{
+				for (int a = 0; a < op.argsSize; ++a)
+				{
+					if (op.args[a].kind == ProcArgIntWrite)
+					{
+						known.reset(op.args[a].value);
+					}
+				}
+			}
+		}
+		return changed;
+	};
+
+	// remove values that are overwritten before anything read them
+	auto removeDeadStores = [&]
+	{
+		bool changed = false;
+		for (int i = 0; i < last; ++i)
+		{
+			auto& op = ops[i];
+			if (op.removed || !isPureStore(op))
+			{
+				continue;
+			}
+			const auto reg = op.args[0].value;
+			for (int j = nextLive(i); j >= 0; j = nextLive(j))
+			{
+				const auto& next = ops[j];
+				const auto base = baseOf(next);
+				if (isProcTerminator(base) || isProcFallible(base) || hasData(next))
+				{
+					break;
+				}
+				if (isPureStore(next) && next.args[0].value == reg)
+				{
+					op.removed = true;
+					changed = true;
+					break;
+				}
+				if (usesReg(next, reg))
+				{
+					break;
+				}
+			}
+		}
+		return changed;
+	};
+
+	// remove code that can't be reached from start of script
+	auto removeUnreachable = [&]
+	{
+		bool changed = false;
+		std::vector<bool> reached(ops.size());
+		std::vector<int> stack = { live(0) };
+		while (!stack.empty())
+		{
+			const int i = stack.back();
+			stack.pop_back();
+			if (reached[i])
+			{
+				continue;
+			}
+			reached[i] = true;
+			const auto& op = ops[i];
+			if (!isProcTerminator(baseOf(op)) && i < last)
+			{
+				stack.push_back(nextLive(i));
+			}
+			for (int a = 0; a < op.argsSize; ++a)
+			{
+				if (op.args[a].kind == ProcArgLabel)
+				{
+					stack.push_back(labelTarget(op.args[a].value));
+				}
+			}
+			forEachDataLabel(op, [&](ScriptInt l) { stack.push_back(labelTarget(l)); });
+		}
+		for (int i = 0; i < last; ++i)
+		{
+			if (!ops[i].removed && !reached[i])
+			{
+				ops[i].removed = true;
+				changed = true;
+			}
+		}
+		for (int i = 0; i < last; ++i)
+		{
+			auto& op = ops[i];
+			if (!op.removed && baseOf(op) == Proc_goto && labelTarget(op.args[0].value) == nextLive(i))
+			{
+				op.removed = true;
+				changed = true;
+			}
+		}
+		return changed;
+	};
+
+	// call followed by operation that use its result is done by one operation
+	auto fuseCalls = [&]
+	{
+		updateTargets();
+		for (int i = 0; i < last; ++i)
+		{
+			auto& op = ops[i];
+			if (op.removed || baseOf(op) != Proc_call)
+			{
+				continue;
+			}
+			bool jumps = false;
+			forEachDataLabel(op, [&](ScriptInt) { jumps = true; });
+			auto& next = ops[nextLive(i)];
+			if (jumps || next.target)
+			{
+				continue;
+			}
+			const auto base = baseOf(next);
+			const int fused =
+				base == Proc_add ? Proc_call_add :
+				base == Proc_test_le ? Proc_call_test_le :
+				base == Proc_test_eq ? Proc_call_test_eq :
+				-1;
+			if (fused < 0)
+			{
+				continue;
+			}
+			OptArg args[ProcArgMax];
+			std::copy(op.args, op.args + op.argsSize, args);
+			std::copy(next.args, next.args + next.argsSize, args + op.argsSize);
+			if (rebuildProc(op, fused, args, op.argsSize + next.argsSize))
+			{
+				next.removed = true;
+			}
+		}
+	};
+
+	for (int pass = 0; pass < 16; ++pass)
+	{
+		bool changed = threadJumps();
+		changed |= removeUnreachable();
+		changed |= foldConstants();
+		changed |= removeDeadStores();
+		if (!changed)
+		{
+			break;
+		}
+	}
+	fuseCalls();
+
+	// write new proc vector
+	std::vector<size_t> newPos(ops.size());
+	size_t size = 0;
+	for (size_t i = 0; i < ops.size(); ++i)
+	{
+		newPos[i] = size;
+		if (!ops[i].removed)
+		{
+			size += 1 + info[ops[i].id].size;
+		}
+	}
+
+	std::vector<Uint8> result(size, 0);
+	decltype(refLabels.positions) labelPositions;
+	decltype(refTexts.positions) textPositions;
+	for (size_t i = 0; i < ops.size(); ++i)
+	{
+		const auto& op = ops[i];
+		if (op.removed)
+		{
+			continue;
+		}
+		const auto& curr = info[op.id];
+		const auto pos = newPos[i];
+		result[pos] = static_cast<Uint8>(op.id);
+		for (int a = 0; a < op.argsSize; ++a)
+		{
+			const auto& arg = op.args[a];
+			const auto argPos = pos + 1 + curr.argOffset[a];
+			switch (arg.kind)
+			{
+			case ProcArgIntRead:
+			case ProcArgIntWrite:
+			case ProcArgRegRead:
+			case ProcArgRegWrite:
+				result[argPos] = static_cast<Uint8>(arg.value);
+				break;
+			case ProcArgIntConst:
+				memcpy(&result[argPos], &arg.value, sizeof(ScriptInt));
+				break;
+			case ProcArgLabel:
+				labelPositions.emplace_back(ReservedPos<ProgPos>{ static_cast<ProgPos>(argPos) }, static_cast<LabelRef>(arg.value));
+				break;
+			case ProcArgData:
+				memcpy(&result[argPos], &proc[arg.pos], arg.size);
+				for (auto it = labelUses.lower_bound(arg.pos); it != labelUses.end() && it->first < arg.pos + arg.size; ++it)
+				{
+					labelPositions.emplace_back(ReservedPos<ProgPos>{ static_cast<ProgPos>(argPos + it->first - arg.pos) }, static_cast<LabelRef>(it->second));
+				}
+				for (auto it = textUses.lower_bound(arg.pos); it != textUses.end() && it->first < arg.pos + arg.size; ++it)
+				{
+					textPositions.emplace_back(ReservedPos<ScriptText>{ static_cast<ProgPos>(argPos + it->first - arg.pos) }, static_cast<TextRef>(it->second));
+				}
+				break;
+			case ProcArgNone:
+				break;
+			}
+		}
+	}
+
+	for (size_t l = 0; l < labelOp.size(); ++l)
+	{
+		if (labelOp[l] >= 0)
+		{
+			refLabels.values[l] = static_cast<ProgPos>(newPos[live(labelOp[l])]);
+		}
+	}
+	refLabels.positions = std::move(labelPositions);
+	refTexts.positions = std::move(textPositions);
+	proc = std::move(result);
+}
+
 /**
  * Returns reference based on name.
  * @param s name of reference.
@@ -1851,6 +2827,16 @@ ScriptRefData ParserWriter::getReferece(const ScriptRef& s) const
 	if (ptr == nullptr)
 	{
 		ptr = parser.getRef(s);
+		if (ptr)
+		{
+			for (Uint8 i = 0; i < parser.getParamSize(); ++i)
+			{
+				if (parser.getParamData(i) == ptr)
+				{
+					container._paramUsed |= 1 << i;
+				}
+			}
+		}
 	}
 	if (ptr == nullptr)
 	{
@@ -2489,6 +3475,7 @@ bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::str
 				Log(LOG_ERROR) << err << "script need to end with return statement";
 			}
 			help.relese();
+			tempScript._profile = ScriptProfiler::addEntry(_name, parentName, _shared->getLoadingModName());
 			destScript = std::move(tempScript);
 			return true;
 		}
@@ -2837,6 +3824,10 @@ void ScriptParserEventsBase::load(const YAML::Node& node)
 				ScriptContainerBase scp;
 				if (parseBase(scp, "Global Event Script", i["code"].as<std::string>("")))
 				{
+					if (auto profile = scp.getProfile())
+					{
+						profile->script += " " + i["offset"].as<std::string>();
+					}
 					data.script = std::move(scp);
 					_eventsData.push_back(std::move(data));
 				}
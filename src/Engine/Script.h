@@ -44,6 +44,7 @@ class ScriptParserBase;
 class ScriptParserEventsBase;
 class ScriptContainerBase;
 class ScriptContainerEventsBase;
+struct ScriptProfileEntry;
 
 struct ParserWriter;
 class SelectedToken;
@@ -373,7 +374,10 @@ struct TypeInfo
 class ScriptContainerBase
 {
 	friend struct ParserWriter;
+	friend class ScriptParserBase;
 	std::vector<Uint8> _proc;
+	Uint16 _paramUsed = 0;
+	ScriptProfileEntry* _profile = nullptr;
 
 public:
 	/// Constructor.
@@ -402,6 +406,18 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+
+	/// Test if script code refers to given script parameter.
+	bool isParamUsed(size_t i) const
+	{
+		return (_paramUsed >> i) & 1;
+	}
+
+	/// Get profiler counters of this script, if it is profiled.
+	ScriptProfileEntry* getProfile() const
+	{
+		return _profile;
+	}
 };
 
 /**
@@ -439,6 +455,28 @@ public:
 		return true;
 	}
 
+	/// Test if script or any of global events have code to run.
+	bool haveAnyScript() const
+	{
+		if (_current)
+		{
+			return true;
+		}
+		auto ptr = _events;
+		if (ptr)
+		{
+			if (*ptr)
+			{
+				return true;
+			}
+			++ptr;
+			if (*ptr)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
 	/// Get pointer to proc data.
 	const Uint8* data() const
 	{
@@ -449,6 +487,38 @@ public:
 	{
 		return _events;
 	}
+	/// Get profiler counters of this script, if it is profiled.
+	ScriptProfileEntry* getProfile() const
+	{
+		return _current.getProfile();
+	}
+
+	/// Test if script or any of global events refers to given script parameter.
+	bool isParamUsed(size_t i) const
+	{
+		if (_current.isParamUsed(i))
+		{
+			return true;
+		}
+		auto ptr = _events;
+		if (ptr)
+		{
+			// events before and after the script, each list ends with an empty script
+			for (int list = 0; list < 2; ++list)
+			{
+				while (*ptr)
+				{
+					if (ptr->isParamUsed(i))
+					{
+						return true;
+					}
+					++ptr;
+				}
+				++ptr;
+			}
+		}
+		return false;
+	}
 };
 
 /**
@@ -598,6 +668,7 @@ struct ScriptOutputArgs<>
 class ScriptWorkerBase
 {
 	std::string log_buffer;
+	Uint64* op_counter = nullptr;
 	ScriptRawMemory<ScriptMaxReg> reg;
 
 	static constexpr int RegSet = 1;
@@ -699,7 +770,7 @@ protected:
 	}
 
 	/// Call script.
-	void executeBase(const Uint8* proc);
+	void executeBase(const Uint8* proc, ScriptProfileEntry* profile);
 
 public:
 	/// Default constructor.
@@ -723,6 +794,17 @@ public:
 		return ret;
 	}
 
+	/// Get raw memory of all registers.
+	const void* getRegData() const
+	{
+		return &reg;
+	}
+	/// Count operations executed by scripts in given variable, used by benchmarks.
+	void setOpCounter(Uint64* counter)
+	{
+		op_counter = counter;
+	}
+
 	/// Add text to log buffer.
 	void log_buffer_add(FuncRef<std::string()> func);
 	/// Flush buffer to log file.
@@ -758,7 +840,7 @@ public:
 		static_assert(std::is_same<typename Parent::Output, Output>::value, "Incompatible script output type");
 
 		set(arg);
-		executeBase(c.data());
+		executeBase(c.data(), c.getProfile());
 		get(arg);
 	}
 
@@ -775,19 +857,19 @@ public:
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(ptr->data(), ptr->getProfile());
 				++ptr;
 			}
 			++ptr;
 		}
 		reset(arg);
-		executeBase(c.data());
+		executeBase(c.data(), c.getProfile());
 		if (ptr)
 		{
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(ptr->data(), ptr->getProfile());
 				++ptr;
 			}
 		}
@@ -802,14 +884,30 @@ class ScriptWorkerBlit : public ScriptWorkerBase
 {
 	/// Current script set in worker.
 	const Uint8* _proc;
+	ScriptProfileEntry* _profile;
 	const ScriptContainerBase* _events;
+	/// Script reads pixel it draws over.
+	bool _destUsed;
+	/// Script reads object passed by pointer.
+	bool _pointerUsed;
+
+	/// Test if script reads any of arguments passed by pointer.
+	template<typename... Args, typename Container>
+	static bool readsPointerArgs(const Container& c)
+	{
+		// first two params are new and old pixel
+		size_t i = 2;
+		bool used = false;
+		((used = used || (std::is_pointer<Args>::value && c.isParamUsed(i)), ++i), ...);
+		return used;
+	}
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _profile(nullptr), _events(nullptr), _destUsed(false), _pointerUsed(false)
 	{
 
 	}
@@ -823,7 +921,10 @@ public:
 		if (c)
 		{
 			_proc = c.data();
+			_profile = c.getProfile();
 			_events = nullptr;
+			_destUsed = c.isParamUsed(1);
+			_pointerUsed = readsPointerArgs<Args...>(c);
 			updateBase<Output>(args...);
 		}
 	}
@@ -837,7 +938,10 @@ public:
 		if (c)
 		{
 			_proc = c.data();
+			_profile = c.getProfile();
 			_events = c.dataEvents();
+			_destUsed = c.isParamUsed(1);
+			_pointerUsed = readsPointerArgs<Args...>(c);
 			updateBase<Output>(args...);
 		}
 	}
@@ -847,11 +951,40 @@ public:
 	/// Programmable blitting using script.
 	void executeBlit(Surface* src, Surface* dest, int x, int y, int shade, GraphSubset mask);
 
+	/// Is there any script set in worker?
+	bool haveScript() const
+	{
+		return _proc != nullptr;
+	}
+	/// Does the script result depend on the destination surface?
+	bool isDestUsed() const
+	{
+		return _destUsed;
+	}
+	/// Does the script read objects passed by pointer?
+	bool isPointerUsed() const
+	{
+		return _pointerUsed;
+	}
+	/// Get script set in worker.
+	const Uint8* getProc() const
+	{
+		return _proc;
+	}
+	/// Get global events set in worker.
+	const ScriptContainerBase* getEvents() const
+	{
+		return _events;
+	}
+
 	/// Clear all worker data.
 	void clear()
 	{
 		_proc = nullptr;
+		_profile = nullptr;
 		_events = nullptr;
+		_destUsed = false;
+		_pointerUsed = false;
 	}
 };
 
@@ -1603,6 +1736,7 @@ private:
 	std::map<ArgEnum, TagData> _tagNames;
 	std::vector<TagValueType> _tagValueTypes;
 	std::vector<ScriptRefData> _refList;
+	std::string _loadingModName;
 
 	/// Get tag value.
 	size_t getTag(ArgEnum type, ScriptRef s) const;
@@ -1628,6 +1762,11 @@ public:
 	/// Store parser.
 	void pushParser(const std::string& groupName, ScriptParserEventsBase* parser);
 
+	/// Set name of mod that scripts are loaded from now.
+	void setLoadingModName(const std::string& name) { _loadingModName = name; }
+	/// Get name of mod that scripts are loaded from now.
+	const std::string& getLoadingModName() const { return _loadingModName; }
+
 	/// Add new const value.
 	void addConst(const std::string& name, ScriptValueData i);
 	/// Update const value.
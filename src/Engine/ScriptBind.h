@@ -91,6 +91,8 @@ struct ParserWriter
 	template<typename T, typename CompType = T>
 	class ReservedCrossRefrenece
 	{
+		friend struct ParserWriter;
+
 		enum Ref : std::size_t { };
 
 		/// list of places of usage.
@@ -163,6 +165,8 @@ struct ParserWriter
 
 	/// Final fixes of data.
 	void relese();
+	/// Simplify operations in proc vector.
+	void optimize();
 
 	/// Get reference based on name.
 	ScriptRefData getReferece(const ScriptRef& s) const;
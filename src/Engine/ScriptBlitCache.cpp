@@ -0,0 +1,149 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScriptBlitCache.h"
+#include <cstring>
+#include "Script.h"
+#include "ShaderDraw.h"
+#include "ShaderMove.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Mixes raw bytes into a FNV-1a hash.
+ */
+Uint64 hashBytes(Uint64 hash, const void *data, size_t size)
+{
+	const Uint8 *bytes = (const Uint8*)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+} // namespace
+
+/**
+ * Creates an empty cache.
+ */
+ScriptBlitCache::ScriptBlitCache() : _size(0)
+{
+
+}
+
+/**
+ * Cleans up the cache.
+ */
+ScriptBlitCache::~ScriptBlitCache()
+{
+
+}
+
+/**
+ * Finds a sprite recolored with the same script and arguments.
+ * @param key Hash of the script and arguments.
+ * @param work Worker with script and arguments set.
+ * @param src Source sprite.
+ * @param shade Shade of the blit.
+ * @return Cached sprite or null.
+ */
+Surface *ScriptBlitCache::find(Uint64 key, const ScriptWorkerBlit &work, Surface *src, int shade)
+{
+	auto range = _entries.equal_range(key);
+	for (auto i = range.first; i != range.second; ++i)
+	{
+		Entry &e = i->second;
+		if (e.src == src && e.proc == work.getProc() && e.events == work.getEvents() && e.shade == shade &&
+			memcmp(e.regs.data(), work.getRegData(), ScriptMaxReg) == 0)
+		{
+			return &e.sprite;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Blits a sprite using the script set in the worker. Scripts that read
+ * neither the destination pixel nor the item behind their pointer
+ * arguments are run once per sprite and arguments, later blits only copy
+ * the recolored pixels.
+ * @param work Worker with script and arguments set.
+ * @param src Source sprite.
+ * @param dest Destination surface.
+ * @param x X offset of the source sprite.
+ * @param y Y offset of the source sprite.
+ * @param shade Shade of the blit.
+ * @param mask Part of the destination surface that can be drawn on.
+ */
+void ScriptBlitCache::executeBlit(ScriptWorkerBlit &work, Surface *src, Surface *dest, int x, int y, int shade, GraphSubset mask)
+{
+	if (!work.haveScript() || work.isDestUsed() || work.isPointerUsed())
+	{
+		work.executeBlit(src, dest, x, y, shade, mask);
+		return;
+	}
+
+	Uint64 key = 14695981039346656037ull;
+	const void *ptrs[] = { src, work.getProc(), work.getEvents() };
+	key = hashBytes(key, ptrs, sizeof(ptrs));
+	key = hashBytes(key, &shade, sizeof(shade));
+	key = hashBytes(key, work.getRegData(), ScriptMaxReg);
+
+	Surface *sprite = find(key, work, src, shade);
+	if (!sprite)
+	{
+		size_t size = (size_t)src->getWidth() * src->getHeight();
+		if (_size + size > MaxSize)
+		{
+			clear();
+		}
+		const Uint8 *regs = (const Uint8*)work.getRegData();
+		Entry entry = { src, work.getProc(), work.getEvents(), shade, std::vector<Uint8>(regs, regs + ScriptMaxReg), Surface(src->getWidth(), src->getHeight()) };
+		sprite = &_entries.emplace(key, std::move(entry))->second.sprite;
+		_size += size;
+
+		// transparent or unchanged pixels stay zero, the same as if the script left the destination alone
+		sprite->lock();
+		work.executeBlit(src, sprite, 0, 0, shade);
+		sprite->unlock();
+	}
+
+	ShaderMove<Uint8> srcShader(sprite, x, y);
+	ShaderMove<Uint8> destShader(dest, 0, 0);
+
+	destShader.setDomain(mask);
+
+	ShaderDraw<helper::TransparentCopy>(destShader, srcShader);
+}
+
+/**
+ * Drops all cached sprites.
+ */
+void ScriptBlitCache::clear()
+{
+	_entries.clear();
+	_size = 0;
+}
+
+}
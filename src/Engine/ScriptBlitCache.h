@@ -0,0 +1,74 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <unordered_map>
+#include "Surface.h"
+#include "GraphSubset.h"
+
+namespace OpenXcom
+{
+
+class ScriptWorkerBlit;
+class ScriptContainerBase;
+
+/**
+ * Keeps item sprites already recolored by blit scripts, so an unchanged
+ * item is drawn with a plain transparent copy instead of running
+ * the script for each of its pixels again.
+ * Sprites are keyed by the source surface, the script and all its arguments.
+ * Scripts that look into the item passed to them are never cached,
+ * as the state behind the pointer can change without the key changing.
+ * Unit body sprites don't go through the cache, their recolor scripts
+ * nearly always read the unit.
+ */
+class ScriptBlitCache
+{
+	struct Entry
+	{
+		Surface *src;
+		const Uint8 *proc;
+		const ScriptContainerBase *events;
+		int shade;
+		std::vector<Uint8> regs;
+		Surface sprite;
+	};
+
+	std::unordered_multimap<Uint64, Entry> _entries;
+	size_t _size;
+
+	/// Finds a sprite recolored with the same script and arguments.
+	Surface *find(Uint64 key, const ScriptWorkerBlit &work, Surface *src, int shade);
+public:
+	/// Limit of cached pixels, the whole cache is dropped after it is reached.
+	static const size_t MaxSize = 1024 * 1024;
+
+	/// Creates an empty cache.
+	ScriptBlitCache();
+	/// Cleans up the cache.
+	~ScriptBlitCache();
+	/// Blits a sprite using the script set in the worker, through the cache if possible.
+	void executeBlit(ScriptWorkerBlit &work, Surface *src, Surface *dest, int x, int y, int shade, GraphSubset mask);
+	/// Drops all cached sprites.
+	void clear();
+	/// Gets the number of cached sprites.
+	size_t size() const { return _entries.size(); }
+};
+
+}
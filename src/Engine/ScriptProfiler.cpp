@@ -0,0 +1,146 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScriptProfiler.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "CrossPlatform.h"
+#include "Logger.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+bool ScriptProfiler::_enabled = false;
+std::deque<ScriptProfileEntry> ScriptProfiler::_entries;
+
+namespace
+{
+
+/**
+ * Quotes a CSV field if needed.
+ * @param s Field text.
+ * @return Text safe to put in a CSV row.
+ */
+std::string csvField(const std::string &s)
+{
+	if (s.find_first_of(",\"\n") == std::string::npos)
+	{
+		return s;
+	}
+	std::string quoted = "\"";
+	for (char c : s)
+	{
+		if (c == '"')
+		{
+			quoted += '"';
+		}
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+}
+
+/**
+ * Turns profiling on or off. Only scripts parsed
+ * afterwards are affected, so it has to be set before
+ * the mods are loaded.
+ * @param enabled Profile new scripts?
+ */
+void ScriptProfiler::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+/**
+ * Drops all the entries with their counters.
+ * Only safe when the scripts pointing to them were destroyed.
+ */
+void ScriptProfiler::clear()
+{
+	_entries.clear();
+}
+
+/**
+ * Creates the entry of a newly parsed script.
+ * @param hook Name of the script hook.
+ * @param script Name of the rule or global event owning the script.
+ * @param mod Name of the mod the script comes from.
+ * @return Entry with stable address, or null if profiling is off.
+ */
+ScriptProfileEntry *ScriptProfiler::addEntry(const std::string &hook, const std::string &script, const std::string &mod)
+{
+	if (!_enabled)
+	{
+		return nullptr;
+	}
+	_entries.emplace_back();
+	ScriptProfileEntry &entry = _entries.back();
+	entry.hook = hook;
+	entry.script = script;
+	entry.mod = mod;
+	return &entry;
+}
+
+/**
+ * Writes one row for every script that was run at least once,
+ * the most expensive first.
+ * @param out Stream to write to.
+ */
+void ScriptProfiler::report(std::ostream &out)
+{
+	std::vector<const ScriptProfileEntry*> used;
+	for (const auto &entry : _entries)
+	{
+		if (entry.calls > 0)
+		{
+			used.push_back(&entry);
+		}
+	}
+	std::sort(used.begin(), used.end(), [](const ScriptProfileEntry *a, const ScriptProfileEntry *b) { return a->nanoseconds > b->nanoseconds; });
+
+	out << "hook,script,mod,calls,ops,total_ns,avg_ns,avg_ops" << std::endl;
+	for (const auto *entry : used)
+	{
+		out << csvField(entry->hook) << ',' << csvField(entry->script) << ',' << csvField(entry->mod) << ',';
+		out << entry->calls << ',' << entry->ops << ',' << entry->nanoseconds << ',';
+		out << entry->nanoseconds / entry->calls << ',' << entry->ops / entry->calls << std::endl;
+	}
+}
+
+/**
+ * Saves the report as script_profile.csv in the user folder.
+ */
+void ScriptProfiler::save()
+{
+	std::ostringstream ss;
+	report(ss);
+	const std::string filename = Options::getMasterUserFolder() + "script_profile.csv";
+	if (CrossPlatform::writeFile(filename, ss.str()))
+	{
+		Log(LOG_INFO) << "Script profile saved to " << filename;
+	}
+	else
+	{
+		Log(LOG_ERROR) << "Failed to save script profile to " << filename;
+	}
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+#include <deque>
+#include <ostream>
+#include <string>
+
+namespace OpenXcom
+{
+
+/**
+ * Counters of one parsed script, every worker running it adds to them.
+ */
+struct ScriptProfileEntry
+{
+	/// Name of the script hook, like `damageUnit`.
+	std::string hook;
+	/// Rule or global event the script belongs to.
+	std::string script;
+	/// Mod the script was loaded from.
+	std::string mod;
+	Uint64 calls = 0;
+	Uint64 ops = 0;
+	Uint64 nanoseconds = 0;
+};
+
+/**
+ * Opt-in accounting of the time spent in mod scripts.
+ * While enabled, every script parsed gets its own entry and each run
+ * adds the executed operations and the wall-clock time to it.
+ * Scripts parsed while disabled have no entry and cost one branch per run.
+ */
+class ScriptProfiler
+{
+	static bool _enabled;
+	static std::deque<ScriptProfileEntry> _entries;
+public:
+	/// Turns profiling of newly parsed scripts on or off.
+	static void setEnabled(bool enabled);
+	/// Are newly parsed scripts profiled?
+	static bool isEnabled() { return _enabled; }
+	/// Drops all entries, the scripts using them must be gone.
+	static void clear();
+	/// Creates the entry of a newly parsed script.
+	static ScriptProfileEntry *addEntry(const std::string &hook, const std::string &script, const std::string &mod);
+	/// Adds one run of a script.
+	static void add(ScriptProfileEntry *entry, Uint64 ops, Uint64 nanoseconds)
+	{
+		entry->calls++;
+		entry->ops += ops;
+		entry->nanoseconds += nanoseconds;
+	}
+	/// Writes all scripts that were run as CSV.
+	static void report(std::ostream &out);
+	/// Saves the CSV report to the user folder.
+	static void save();
+};
+
+}
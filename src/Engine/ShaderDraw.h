@@ -19,7 +19,10 @@
  */
 #include "ShaderDrawHelper.h"
 #include "HelperMeta.h"
+#include "ShaderDrawRow.h"
 #include <tuple>
+#include <cstring>
+#include <type_traits>
 
 namespace OpenXcom
 {
@@ -31,12 +34,12 @@ static inline First&& GetFirst(First&& f, Rest&&... r)
 }
 
 /**
- * Universal blit function implementation.
- * @param f called function.
+ * Universal blit function implementation, iterate over rows of draw range.
+ * @param row function called for each row with its size, controls objects point to first pixel of that row.
  * @param src source surfaces control objects.
  */
-template<typename Func, typename... SrcType>
-static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
+template<typename RowFunc, typename... SrcType>
+static inline void ShaderDrawRows(RowFunc&& row, helper::controler<SrcType>&... src)
 {
 	//get basic draw range in 2d space
 	GraphSubset end_temp = GetFirst(src...).get_range();
@@ -77,38 +80,99 @@ static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
 		//set final iteration range
 		(src.set_x(begin_x, end_x), ...);
 
-		int size_x = end_x-begin_x;
-		//iteration on x-axis
-		for (int x = size_x / 4; x>0; --x)
-		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
-		if (size_x & 2)
+		row(end_x-begin_x);
+	}
+}
+
+/**
+ * Universal blit function implementation.
+ * @param f called function.
+ * @param src source surfaces control objects.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
+{
+	ShaderDrawRows(
+		[&](int size_x)
 		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
-		if (size_x & 1)
+			//iteration on x-axis
+			for (int x = size_x / 4; x>0; --x)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+			if (size_x & 2)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+			if (size_x & 1)
+			{
+				f(src.get_ref()...); (src.inc_x(), ...);
+			}
+		},
+		src...
+	);
+}
+
+/**
+ * Universal blit function implementation that process whole rows at once.
+ * @param f called function, get size of row and references to first pixels.
+ * @param src source surfaces control objects, all need have continuous rows.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawRowImpl(Func&& f, helper::controler<SrcType>... src)
+{
+	ShaderDrawRows(
+		[&](int size_x)
 		{
-			f(src.get_ref()...); (src.inc_x(), ...);
-		}
-	}
+			f(size_x, src.get_ref()...);
+		},
+		src...
+	);
+}
+
+namespace helper
+{
+
+/**
+ * Check if `ColorFunc` have static function `funcRow` that process whole row of pixels.
+ */
+template<typename ColorFunc, typename = void>
+struct HaveFuncRow : std::false_type
+{
 
 };
 
+template<typename ColorFunc>
+struct HaveFuncRow<ColorFunc, std::void_t<decltype(&ColorFunc::funcRow)>> : std::true_type
+{
+
+};
+
+}//namespace helper
+
 /**
  * Universal blit function.
  * @tparam ColorFunc class that contains static function `func`.
  * function is used to modify these arguments.
+ * If class have function `funcRow` too and all surfaces have continuous rows,
+ * it will be called for every row instead of calling `func` for every pixel.
  * @param src_frame destination and source surfaces modified by function.
  */
 template<typename ColorFunc, typename... SrcType>
 static inline void ShaderDraw(const SrcType&... src_frame)
 {
-	ShaderDrawImpl([](auto&&... a){ ColorFunc::func(std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
+	if constexpr (helper::HaveFuncRow<ColorFunc>::value && (helper::controler<SrcType>::contiguous_x && ...))
+	{
+		ShaderDrawRowImpl([](int size_x, auto&&... a){ ColorFunc::funcRow(size_x, std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
+	}
+	else
+	{
+		ShaderDrawImpl([](auto&&... a){ ColorFunc::func(std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
+	}
 }
 
 /**
@@ -169,6 +233,18 @@ struct ColorReplace
 #endif
 	}
 
+	/**
+	 * Same as `func` but for whole row of pixels.
+	 * @param size number of pixels in row
+	 * @param dest first destination pixel
+	 * @param src first source pixel
+	 * @param shade value of shade of this surface
+	 * @param newColor new color to set (it should be offset by 4)
+	 */
+	static inline void funcRow(int size, Uint8& dest, const Uint8& src, const int& shade, const int& newColor)
+	{
+		getRowKernels().replace(&dest, &src, size, shade, newColor);
+	}
 };
 
 /**
@@ -213,6 +289,74 @@ struct StandardShade
 #endif
 	}
 
+	/**
+	 * Same as `func` but for whole row of pixels.
+	 * @param size number of pixels in row
+	 * @param dest first destination pixel
+	 * @param src first source pixel
+	 * @param shade value of shade of this surface
+	 */
+	static inline void funcRow(int size, Uint8& dest, const Uint8& src, const int& shade)
+	{
+		getRowKernels().shade(&dest, &src, size, shade);
+	}
+};
+
+/**
+ * help class used for copying surface with transparent pixels
+ */
+struct TransparentCopy
+{
+	/**
+	 * Copy pixel if it is not transparent.
+	 * @param dest destination pixel
+	 * @param src source pixel
+	 */
+	static inline void func(Uint8& dest, const Uint8& src)
+	{
+		if (src)
+		{
+			dest = src;
+		}
+	}
+
+	/**
+	 * Same as `func` but for whole row of pixels.
+	 * @param size number of pixels in row
+	 * @param dest first destination pixel
+	 * @param src first source pixel
+	 */
+	static inline void funcRow(int size, Uint8& dest, const Uint8& src)
+	{
+		getRowKernels().copy(&dest, &src, size);
+	}
+};
+
+/**
+ * help class used for filling surface with one color
+ */
+struct Fill
+{
+	/**
+	 * Set pixel to color.
+	 * @param dest destination pixel
+	 * @param color new color
+	 */
+	static inline void func(Uint8& dest, const Uint8& color)
+	{
+		dest = color;
+	}
+
+	/**
+	 * Same as `func` but for whole row of pixels.
+	 * @param size number of pixels in row
+	 * @param dest first destination pixel
+	 * @param color new color
+	 */
+	static inline void funcRow(int size, Uint8& dest, const Uint8& color)
+	{
+		std::memset(&dest, color, size);
+	}
 };
 /**
  * helper class used for blitting dying unit with overkill
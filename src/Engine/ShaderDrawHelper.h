@@ -191,6 +191,9 @@ struct controler
 template<typename T>
 struct controler<Scalar<T> >
 {
+	/// same value for every pixel, can be used by row functions.
+	static constexpr bool contiguous_x = true;
+
 	T& ref;
 
 	inline controler(const Scalar<T>& s) : ref(s.ref)
@@ -246,6 +249,8 @@ struct controler<Scalar<T> >
 template<typename PixelPtr, typename PixelRef>
 struct controler_base
 {
+	/// pixels in one row are next to each other in memory, can be used by row functions.
+	static constexpr bool contiguous_x = true;
 
 	const PixelPtr data;
 	PixelPtr ptr_pos_y;
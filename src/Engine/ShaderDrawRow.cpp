@@ -0,0 +1,273 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ShaderDrawRow.h"
+#include "ShaderDraw.h"
+#include "Zoom.h"
+
+#if (_MSC_VER >= 1400) || (defined(__MINGW32__) && defined(__SSE2__))
+
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+// probably Visual Studio (or Intel C++ which should also work)
+#include <intrin.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(__GNUC__)
+// GCC and Clang need AVX2 enabled per function, rest of the file is build for base instruction set
+#define OXCE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OXCE_TARGET_AVX2
+#endif
+#endif
+
+namespace OpenXcom
+{
+
+namespace helper
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////
+//					Scalar
+////////////////////////////////////////////////////////////
+
+void copyScalar(Uint8* dest, const Uint8* src, int size)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		TransparentCopy::func(dest[i], src[i]);
+	}
+}
+
+void shadeScalar(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		StandardShade::func(dest[i], src[i], shade);
+	}
+}
+
+void replaceScalar(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		ColorReplace::func(dest[i], src[i], shade, newColor);
+	}
+}
+
+const RowKernels KernelsScalar = { "scalar", &copyScalar, &shadeScalar, &replaceScalar };
+
+#ifdef __SSE2__
+
+////////////////////////////////////////////////////////////
+//					SSE2
+////////////////////////////////////////////////////////////
+
+/**
+ * Select `b` where `mask` is set, otherwise `a`.
+ */
+inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+}
+
+void copySSE2(Uint8* dest, const Uint8* src, int size)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+		_mm_storeu_si128((__m128i*)(dest + i), selectSSE2(transparent, s, d));
+	}
+	copyScalar(dest + i, src + i, size - i);
+}
+
+void shadeSSE2(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)ColorShade);
+	const __m128i offset = _mm_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		const __m128i newShade = _mm_add_epi8(s, offset);
+		const __m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(newShade, s), group), zero);
+		const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+		const __m128i result = selectSSE2(sameGroup, black, newShade);
+		_mm_storeu_si128((__m128i*)(dest + i), selectSSE2(transparent, result, d));
+	}
+	shadeScalar(dest + i, src + i, size - i, shade);
+}
+
+void replaceSSE2(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)ColorShade);
+	const __m128i offset = _mm_set1_epi8((char)shade);
+	const __m128i color = _mm_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		const __m128i newShade = _mm_add_epi8(_mm_and_si128(s, black), offset);
+		const __m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(newShade, group), zero);
+		const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+		const __m128i result = selectSSE2(sameGroup, black, _mm_or_si128(newShade, color));
+		_mm_storeu_si128((__m128i*)(dest + i), selectSSE2(transparent, result, d));
+	}
+	replaceScalar(dest + i, src + i, size - i, shade, newColor);
+}
+
+const RowKernels KernelsSSE2 = { "SSE2", &copySSE2, &shadeSSE2, &replaceSSE2 };
+
+////////////////////////////////////////////////////////////
+//					AVX2
+////////////////////////////////////////////////////////////
+
+OXCE_TARGET_AVX2 void copyAVX2(Uint8* dest, const Uint8* src, int size)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	int i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		const __m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(s, d, transparent));
+	}
+	copySSE2(dest + i, src + i, size - i);
+}
+
+OXCE_TARGET_AVX2 void shadeAVX2(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)ColorShade);
+	const __m256i offset = _mm256_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		const __m256i newShade = _mm256_add_epi8(s, offset);
+		const __m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_xor_si256(newShade, s), group), zero);
+		const __m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		const __m256i result = _mm256_blendv_epi8(black, newShade, sameGroup);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(result, d, transparent));
+	}
+	shadeSSE2(dest + i, src + i, size - i, shade);
+}
+
+OXCE_TARGET_AVX2 void replaceAVX2(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)ColorShade);
+	const __m256i offset = _mm256_set1_epi8((char)shade);
+	const __m256i color = _mm256_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		const __m256i newShade = _mm256_add_epi8(_mm256_and_si256(s, black), offset);
+		const __m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(newShade, group), zero);
+		const __m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		const __m256i result = _mm256_blendv_epi8(black, _mm256_or_si256(newShade, color), sameGroup);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(result, d, transparent));
+	}
+	replaceSSE2(dest + i, src + i, size - i, shade, newColor);
+}
+
+const RowKernels KernelsAVX2 = { "AVX2", &copyAVX2, &shadeAVX2, &replaceAVX2 };
+
+#endif
+
+/**
+ * Pick best set of row functions for current CPU.
+ */
+const RowKernels* selectRowKernels()
+{
+	for (int i = ROW_KERNELS_MAX - 1; i > ROW_KERNELS_SCALAR; --i)
+	{
+		if (auto k = getRowKernels((RowKernelsType)i))
+		{
+			return k;
+		}
+	}
+	return &KernelsScalar;
+}
+
+} //namespace
+
+/**
+ * Get given set of row functions.
+ * @param type Instruction set of functions.
+ * @return Functions or null if current build or CPU do not support this instruction set.
+ */
+const RowKernels* getRowKernels(RowKernelsType type)
+{
+	switch (type)
+	{
+	case ROW_KERNELS_SCALAR:
+		return &KernelsScalar;
+#ifdef __SSE2__
+	case ROW_KERNELS_SSE2:
+	{
+		static const bool haveSSE2 = Zoom::haveSSE2();
+		return haveSSE2 ? &KernelsSSE2 : nullptr;
+	}
+	case ROW_KERNELS_AVX2:
+	{
+		static const bool haveAVX2 = Zoom::haveSSE2() && Zoom::haveAVX2();
+		return haveAVX2 ? &KernelsAVX2 : nullptr;
+	}
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+/**
+ * Get best set of row functions supported by current CPU.
+ * @return Functions using widest available instruction set.
+ */
+const RowKernels& getRowKernels()
+{
+	static const RowKernels* const best = selectRowKernels();
+	return *best;
+}
+
+}//namespace helper
+
+}//namespace OpenXcom
@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+namespace helper
+{
+
+/**
+ * Functions that process whole row of 8bit pixels at once.
+ * Every set gives same results as scalar functions used by `ShaderDraw`,
+ * vector versions only process more pixels per instruction.
+ */
+struct RowKernels
+{
+	/// Name of instruction set used by these functions.
+	const char* name;
+	/// Copy all non zero pixels, same as `TransparentCopy::func`.
+	void (*copy)(Uint8* dest, const Uint8* src, int size);
+	/// Shade pixels, same as `StandardShade::func`.
+	void (*shade)(Uint8* dest, const Uint8* src, int size, int shade);
+	/// Shade pixels and replace color group, same as `ColorReplace::func`.
+	void (*replace)(Uint8* dest, const Uint8* src, int size, int shade, int newColor);
+};
+
+/**
+ * Available sets of row functions.
+ */
+enum RowKernelsType
+{
+	ROW_KERNELS_SCALAR,
+	ROW_KERNELS_SSE2,
+	ROW_KERNELS_AVX2,
+	ROW_KERNELS_MAX
+};
+
+/// Get given set of row functions, or null if current build or CPU do not support it.
+const RowKernels* getRowKernels(RowKernelsType type);
+/// Get best set of row functions supported by current CPU.
+const RowKernels& getRowKernels();
+
+}//namespace helper
+
+}//namespace OpenXcom
@@ -65,6 +65,9 @@ namespace helper
 template<typename Pixel>
 struct controler<ShaderRepeat<Pixel> >
 {
+	/// row wraps around, can't be used by row functions.
+	static constexpr bool contiguous_x = false;
+
 	typedef typename ShaderRepeat<Pixel>::PixelPtr PixelPtr;
 	typedef typename ShaderRepeat<Pixel>::PixelRef PixelRef;
 
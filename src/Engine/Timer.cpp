@@ -41,6 +41,7 @@ Uint32 slowTick()
 
 Uint32 Timer::gameSlowSpeed = 1;
 int Timer::maxFrameSkip = 8; // this is a pretty good default at 60FPS.
+bool Timer::fastForward = false;
 
 
 /**
@@ -112,6 +113,20 @@ void Timer::think(State* state, Surface* surface)
 	Game *game = state ? state->_game : 0; // this is used to make sure we stop calling *_state on *state in the loop once *state has been popped and deallocated
 	//assert(!game || game->isState(state));
 
+	if (_running && fastForward)
+	{
+		// no waiting, just tick once per call
+		if (state != 0 && _state != 0)
+		{
+			(state->*_state)();
+		}
+		if (_running && surface != 0 && _surface != 0)
+		{
+			(surface->*_surface)();
+		}
+		return;
+	}
+
 	if (_running)
 	{
 		if ((now - _frameSkipStart) >= _interval)
@@ -37,6 +37,8 @@ class Timer
 public:
 	static int maxFrameSkip;
 	static Uint32 gameSlowSpeed;
+	/// Every think() counts as one elapsed interval, used by the headless benchmarks.
+	static bool fastForward;
 
 private:
 	Uint32 _start;
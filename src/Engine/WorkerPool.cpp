@@ -0,0 +1,206 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WorkerPool.h"
+#include <algorithm>
+#include <thread>
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+std::vector<SDL_Thread*> WorkerPool::_threads;
+SDL_mutex *WorkerPool::_mutex = 0;
+SDL_cond *WorkerPool::_wake = 0;
+SDL_cond *WorkerPool::_finished = 0;
+WorkerPool::JobFunc WorkerPool::_job = 0;
+void *WorkerPool::_data = 0;
+int WorkerPool::_count = 0;
+int WorkerPool::_next = 0;
+int WorkerPool::_working = 0;
+int WorkerPool::_generation = 0;
+bool WorkerPool::_busy = false;
+bool WorkerPool::_quit = false;
+
+/**
+ * Starts the background threads. Without them every
+ * job simply runs on the calling thread.
+ * @param threads Number of background threads, 0 picks one less than the number of cores.
+ */
+void WorkerPool::start(int threads)
+{
+	stop();
+	if (threads <= 0)
+	{
+		threads = std::min((int)std::thread::hardware_concurrency(), 16) - 1;
+	}
+	if (threads <= 0)
+	{
+		return;
+	}
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_finished = SDL_CreateCond();
+	_quit = false;
+	for (int i = 0; i < threads; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, 0);
+		if (thread == 0)
+		{
+			Log(LOG_WARNING) << "Failed to create worker thread: " << SDL_GetError();
+			break;
+		}
+		_threads.push_back(thread);
+	}
+	Log(LOG_INFO) << "Worker pool started with " << _threads.size() << " threads.";
+}
+
+/**
+ * Wakes up all the background threads, waits
+ * for them to exit and frees their resources.
+ */
+void WorkerPool::stop()
+{
+	if (_mutex == 0)
+	{
+		return;
+	}
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_wake);
+	SDL_UnlockMutex(_mutex);
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	_threads.clear();
+	SDL_DestroyCond(_finished);
+	SDL_DestroyCond(_wake);
+	SDL_DestroyMutex(_mutex);
+	_finished = 0;
+	_wake = 0;
+	_mutex = 0;
+}
+
+/**
+ * Waits for jobs and helps with them until the pool is stopped.
+ * @return Always 0.
+ */
+int WorkerPool::worker(void *)
+{
+	int generation = 0;
+	SDL_LockMutex(_mutex);
+	while (true)
+	{
+		while (!_quit && generation == _generation)
+		{
+			SDL_CondWait(_wake, _mutex);
+		}
+		if (_quit)
+		{
+			break;
+		}
+		generation = _generation;
+		_working++;
+		SDL_UnlockMutex(_mutex);
+
+		work(generation);
+
+		SDL_LockMutex(_mutex);
+		if (--_working == 0)
+		{
+			SDL_CondSignal(_finished);
+		}
+	}
+	SDL_UnlockMutex(_mutex);
+	return 0;
+}
+
+/**
+ * Takes items of a job one at a time and processes them.
+ * A thread that wakes up late finds the job already
+ * finished (or replaced) and returns right away.
+ * @param generation Job the thread was woken up for.
+ */
+void WorkerPool::work(int generation)
+{
+	while (true)
+	{
+		SDL_LockMutex(_mutex);
+		if (generation != _generation || _next >= _count)
+		{
+			SDL_UnlockMutex(_mutex);
+			return;
+		}
+		int index = _next++;
+		JobFunc job = _job;
+		void *data = _data;
+		SDL_UnlockMutex(_mutex);
+		job(data, index);
+	}
+}
+
+/**
+ * Runs a job on all threads and returns once every item is processed.
+ * Items must not depend on each other or change shared state.
+ * @param count Number of items.
+ * @param job Function processing one item.
+ * @param data Data of the job, passed to every call.
+ */
+void WorkerPool::run(int count, JobFunc job, void *data)
+{
+	bool parallel = false;
+	int generation = 0;
+	if (_mutex != 0 && count > 1)
+	{
+		SDL_LockMutex(_mutex);
+		if (!_busy)
+		{
+			_busy = true;
+			parallel = true;
+			_job = job;
+			_data = data;
+			_count = count;
+			_next = 0;
+			generation = ++_generation;
+			SDL_CondBroadcast(_wake);
+		}
+		SDL_UnlockMutex(_mutex);
+	}
+	if (!parallel)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(data, i);
+		}
+		return;
+	}
+
+	work(generation);
+
+	SDL_LockMutex(_mutex);
+	while (_working > 0)
+	{
+		SDL_CondWait(_finished, _mutex);
+	}
+	_count = 0;
+	_busy = false;
+	SDL_UnlockMutex(_mutex);
+}
+
+}
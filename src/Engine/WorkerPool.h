@@ -0,0 +1,69 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Small pool of background threads used to split independent,
+ * read-only work (ray traces, image bands, file parsing) over all cores.
+ * The calling thread takes part in every job and run() only returns
+ * once all items are done, so results are ready in a fixed order.
+ * Jobs started from inside another job run serially on the caller.
+ */
+class WorkerPool
+{
+public:
+	/// Function processing one item of a job.
+	typedef void (*JobFunc)(void *data, int index);
+private:
+	static std::vector<SDL_Thread*> _threads;
+	static SDL_mutex *_mutex;
+	static SDL_cond *_wake, *_finished;
+	static JobFunc _job;
+	static void *_data;
+	static int _count, _next, _working, _generation;
+	static bool _busy, _quit;
+
+	/// Entry point of the background threads.
+	static int worker(void *unused);
+	/// Processes items of a job until none are left.
+	static void work(int generation);
+	/// Calls a functor for one item.
+	template<typename F>
+	static void invoke(void *data, int index) { (*static_cast<F*>(data))(index); }
+public:
+	/// Starts the background threads.
+	static void start(int threads);
+	/// Stops all background threads.
+	static void stop();
+	/// Gets the number of threads taking part in a job, including the caller.
+	static int getThreadCount() { return (int)_threads.size() + 1; }
+	/// Runs a job over items [0, count) and waits for it to finish.
+	static void run(int count, JobFunc job, void *data);
+	/// Runs a functor taking the item index over items [0, count).
+	template<typename F>
+	static void run(int count, F &func) { run(count, &invoke<F>, &func); }
+};
+
+}
@@ -18,11 +18,15 @@
  */
 
 #include "Zoom.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "Surface.h"
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "WorkerPool.h"
 
 #include "OpenGL.h"
 
@@ -44,6 +48,7 @@
 #endif
 // probably Visual Studio (or Intel C++ which should also work)
 #include <intrin.h>
+#include <immintrin.h>
 #endif
 
 #ifdef __GNUC__
@@ -626,6 +631,90 @@ static int zoomSurface2X_SSE2(SDL_Surface *src, SDL_Surface *dst)
 }
  */
 
+/**
+ * Picks how many horizontal bands a scaled frame is split into.
+ * Every thread gets a couple of bands so a slow one doesn't hold up
+ * the whole frame, but bands are kept big enough to be worth
+ * handing out (xBRZ also reads two extra rows for each band).
+ * @param width Width of the source image.
+ * @param height Height of the source image.
+ * @param factor Scale factor.
+ * @return Number of bands, 1 to scale the frame at once.
+ */
+int Zoom::getScalerBands(int width, int height, int factor)
+{
+	const int minBandPixels = 64 * 1024; // of the scaled image
+	const int minBandRows = 8; // of the source image
+	int threads = WorkerPool::getThreadCount();
+	if (threads <= 1)
+	{
+		return 1;
+	}
+	int bands = threads * 2;
+	bands = std::min(bands, width * height * factor * factor / minBandPixels);
+	bands = std::min(bands, height / minBandRows);
+	return std::max(bands, 1);
+}
+
+/**
+ * Scales a 32bpp image with xBRZ, the bands of the
+ * source image are scaled in parallel on the worker pool.
+ * @param factor Scale factor, 2 to 6.
+ * @param src Source pixels.
+ * @param dst Destination pixels, rows must not be padded.
+ * @param width Width of the source image.
+ * @param height Height of the source image.
+ * @param bands Number of bands to split the image into.
+ */
+void Zoom::scaleXbrz(int factor, const Uint32 *src, Uint32 *dst, int width, int height, int bands)
+{
+	auto band = [&](int i)
+	{
+		xbrz::scale(factor, src, dst, width, height, xbrz::RGB, xbrz::ScalerCfg(), height * i / bands, height * (i + 1) / bands);
+	};
+	WorkerPool::run(bands, band);
+}
+
+/**
+ * Scales a 32bpp image with hqNx, the bands of the
+ * source image are scaled in parallel on the worker pool.
+ * @param factor Scale factor, 2 to 4.
+ * @param src Source pixels.
+ * @param srcPitch Bytes per source row.
+ * @param dst Destination pixels.
+ * @param dstPitch Bytes per destination row.
+ * @param width Width of the source image.
+ * @param height Height of the source image.
+ * @param bands Number of bands to split the image into.
+ */
+void Zoom::scaleHqx(int factor, const Uint32 *src, int srcPitch, Uint32 *dst, int dstPitch, int width, int height, int bands)
+{
+	static bool initDone = false;
+	if (!initDone)
+	{
+		hqxInit();
+		initDone = true;
+	}
+
+	auto band = [&](int i)
+	{
+		int yFirst = height * i / bands, yLast = height * (i + 1) / bands;
+		switch (factor)
+		{
+		case 2:
+			hq2x_32_rb_slice(src, srcPitch, dst, dstPitch, width, height, yFirst, yLast);
+			break;
+		case 3:
+			hq3x_32_rb_slice(src, srcPitch, dst, dstPitch, width, height, yFirst, yLast);
+			break;
+		case 4:
+			hq4x_32_rb_slice(src, srcPitch, dst, dstPitch, width, height, yFirst, yLast);
+			break;
+		}
+	};
+	WorkerPool::run(bands, band);
+}
+
 /**
  * Checks the SSE2 feature bit returned by the CPUID instruction
  * @return Does the CPU support SSE2?
@@ -645,6 +734,55 @@ bool Zoom::haveSSE2()
 	return (CPUInfo[3] & 0x04000000) ? true : false;
 }
 
+/**
+ * Checks the AVX2 feature bit returned by the CPUID instruction,
+ * and that the OS saves the AVX registers on context switch.
+ * @return Does the CPU support AVX2?
+ */
+bool Zoom::haveAVX2()
+{
+#ifdef __GNUC__
+	unsigned int CPUInfo[4] = {0, 0, 0, 0};
+	if (__get_cpuid_max(0, 0) < 7)
+	{
+		return false;
+	}
+	__get_cpuid(1, CPUInfo, CPUInfo+1, CPUInfo+2, CPUInfo+3);
+	if ((CPUInfo[2] & 0x18000000) != 0x18000000) // OSXSAVE and AVX
+	{
+		return false;
+	}
+	unsigned int xcrLow = 0, xcrHigh = 0;
+	__asm__ ("xgetbv" : "=a"(xcrLow), "=d"(xcrHigh) : "c"(0));
+	if ((xcrLow & 0x6) != 0x6) // XMM and YMM state
+	{
+		return false;
+	}
+	__cpuid_count(7, 0, CPUInfo[0], CPUInfo[1], CPUInfo[2], CPUInfo[3]);
+#elif _WIN32
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 0);
+	if (CPUInfo[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(CPUInfo, 1);
+	if ((CPUInfo[2] & 0x18000000) != 0x18000000) // OSXSAVE and AVX
+	{
+		return false;
+	}
+	if ((_xgetbv(0) & 0x6) != 0x6) // XMM and YMM state
+	{
+		return false;
+	}
+	__cpuidex(CPUInfo, 7, 0);
+#else
+	unsigned int CPUInfo[4] = {0, 0, 0, 0};
+#endif
+
+	return (CPUInfo[1] & 0x00000020) ? true : false;
+}
+
 #endif
 
 /**
@@ -668,9 +806,18 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 #ifndef __NO_OPENGL
 		if (glOut->buffer_surface)
 		{
-			SDL_BlitSurface(src, 0, glOut->surface.get(), 0); // TODO; this is less than ideal...
+			// upload straight from the source when it already has the texture's layout
+			SDL_Surface *image = src;
+			SDL_PixelFormat *format = glOut->surface->format;
+			if (src->w != glOut->surface->w || src->h != glOut->surface->h || src->pitch != glOut->surface->pitch ||
+				src->format->BitsPerPixel != format->BitsPerPixel || src->format->Rmask != format->Rmask ||
+				src->format->Gmask != format->Gmask || src->format->Bmask != format->Bmask)
+			{
+				SDL_BlitSurface(src, 0, glOut->surface.get(), 0);
+				image = glOut->surface.get();
+			}
 
-			glOut->refresh(glOut->linear, glOut->iwidth, glOut->iheight, dst->w, dst->h, topBlackBand, bottomBlackBand, leftBlackBand, rightBlackBand);
+			glOut->refresh(image, glOut->linear, glOut->iwidth, glOut->iheight, dst->w, dst->h, topBlackBand, bottomBlackBand, leftBlackBand, rightBlackBand);
 			SDL_GL_SwapBuffers();
 		}
 #endif
@@ -686,15 +833,24 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else
 	{
-		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dstWidth, dstHeight, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
-		if (src->format->palette != NULL)
+		// zoom straight into the part of the screen between the black bands
+		static SDL_Surface *view = 0;
+		if (view == 0 || view->w != dstWidth || view->h != dstHeight || view->pitch != dst->pitch || view->format->BitsPerPixel != dst->format->BitsPerPixel)
+		{
+			SDL_FreeSurface(view);
+			view = SDL_CreateRGBSurfaceFrom(dst->pixels, dstWidth, dstHeight, dst->format->BitsPerPixel, dst->pitch,
+				dst->format->Rmask, dst->format->Gmask, dst->format->Bmask, dst->format->Amask);
+		}
+		if (SDL_MUSTLOCK(dst))
+		{
+			SDL_LockSurface(dst);
+		}
+		view->pixels = (Uint8*)dst->pixels + topBlackBand * dst->pitch + leftBlackBand * dst->format->BytesPerPixel;
+		_zoomSurfaceY(src, view, 0, 0);
+		if (SDL_MUSTLOCK(dst))
 		{
-			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
+			SDL_UnlockSurface(dst);
 		}
-		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)tmp->w, (Uint16)tmp->h};
-		SDL_BlitSurface(tmp, NULL, dst, &dstrect);
-		SDL_FreeSurface(tmp);
 	}
 }
 
@@ -732,7 +888,26 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					if (dst->pitch == dst->w * 4 && src->pitch == src->w * 4)
+					{
+						scaleXbrz(factor, (Uint32*)src->pixels, (Uint32*)dst->pixels, src->w, src->h, getScalerBands(src->w, src->h, factor));
+					}
+					else
+					{
+						// xBRZ can't skip padding, so go through a buffer kept between frames
+						static std::vector<Uint32> srcBuffer, dstBuffer;
+						srcBuffer.resize(src->w * src->h);
+						dstBuffer.resize(dst->w * dst->h);
+						for (int row = 0; row < src->h; ++row)
+						{
+							memcpy(&srcBuffer[row * src->w], (Uint8*)src->pixels + row * src->pitch, src->w * 4);
+						}
+						scaleXbrz(factor, srcBuffer.data(), dstBuffer.data(), src->w, src->h, getScalerBands(src->w, src->h, factor));
+						for (int row = 0; row < dst->h; ++row)
+						{
+							memcpy((Uint8*)dst->pixels + row * dst->pitch, &dstBuffer[row * dst->w], dst->w * 4);
+						}
+					}
 					return 0;
 				}
 			}
@@ -740,32 +915,13 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 		if (Options::useHQXFilter)
 		{
-			static bool initDone = false;
-
-			if (!initDone)
-			{
-				hqxInit();
-				initDone = true;
-			}
-
-			// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
-
-			if (dst->w == src->w * 2 && dst->h == src->h * 2)
+			for (int factor = 2; factor <= 4; factor++)
 			{
-				hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
-				return 0;
-			}
-
-			if (dst->w == src->w * 3 && dst->h == src->h * 3)
-			{
-				hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
-				return 0;
-			}
-
-			if (dst->w == src->w * 4 && dst->h == src->h * 4)
-			{
-				hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
-				return 0;
+				if (dst->w == src->w * factor && dst->h == src->h * factor)
+				{
+					scaleHqx(factor, (Uint32*)src->pixels, src->pitch, (Uint32*)dst->pixels, dst->pitch, src->w, src->h, getScalerBands(src->w, src->h, factor));
+					return 0;
+				}
 			}
 		}
 	}
@@ -838,16 +994,24 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	}
 
 	/*
-	* Allocate memory for row increments
+	* Allocate memory for row increments, kept between frames
 	*/
-	if ((sax = (Uint32 *) realloc(sax, (dst->w + 1) * sizeof(Uint32))) == NULL) {
-		sax = 0;
-		return (-1);
+	static int saxSize = 0, saySize = 0;
+	if (saxSize < dst->w + 1)
+	{
+		if ((sax = (Uint32 *) realloc(sax, (dst->w + 1) * sizeof(Uint32))) == NULL) {
+			saxSize = 0;
+			return (-1);
+		}
+		saxSize = dst->w + 1;
 	}
-	if ((say = (Uint32 *) realloc(say, (dst->h + 1) * sizeof(Uint32))) == NULL) {
-		say = 0;
-		//free(sax);
-		return (-1);
+	if (saySize < dst->h + 1)
+	{
+		if ((say = (Uint32 *) realloc(say, (dst->h + 1) * sizeof(Uint32))) == NULL) {
+			saySize = 0;
+			return (-1);
+		}
+		saySize = dst->h + 1;
 	}
 
 	/*
@@ -34,6 +34,14 @@ class Zoom
 	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2();
+	/// Check for AVX2 instructions using CPUID.
+	static bool haveAVX2();
+	/// Picks how many horizontal bands a scaled frame is split into.
+	static int getScalerBands(int width, int height, int factor);
+	/// Scales a 32bpp image with xBRZ, one band per worker.
+	static void scaleXbrz(int factor, const Uint32 *src, Uint32 *dst, int width, int height, int bands);
+	/// Scales a 32bpp image with hqNx, one band per worker.
+	static void scaleHqx(int factor, const Uint32 *src, int srcPitch, Uint32 *dst, int dstPitch, int width, int height, int bands);
 
 private:
 
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeBenchmark.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+#include <yaml-cpp/yaml.h>
+#include "DogfightState.h"
+#include "GeoscapeState.h"
+#include "../Battlescape/BattlescapeGame.h"
+#include "../Battlescape/BattlescapeState.h"
+#include "../Engine/Action.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Engine/Timer.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/GameTime.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Cycles the geoscape may spend without the clock moving before the run is considered stuck.
+const Uint64 STUCK_CYCLES = 1000000;
+/// Turns a battle may last before the run is considered stuck.
+const int STUCK_TURNS = 100;
+/// Cycles a battle may last before the run is considered stuck.
+const Uint64 STUCK_BATTLE_CYCLES = 50000000;
+
+/**
+ * Packs a game date into a number that grows with time.
+ * @param time Game time.
+ * @return Comparable timestamp.
+ */
+int64_t timestamp(const GameTime *time)
+{
+	return ((((int64_t)time->getYear() * 12 + time->getMonth()) * 31 + time->getDay()) * 24 + time->getHour()) * 3600 + time->getMinute() * 60 + time->getSecond();
+}
+
+/**
+ * Formats a game date for the report.
+ * @param time Game time.
+ * @return Date in YYYY-MM-DD HH:MM format.
+ */
+std::string dateString(const GameTime *time)
+{
+	std::ostringstream ss;
+	ss << std::setfill('0') << time->getYear() << "-" << std::setw(2) << time->getMonth() << "-" << std::setw(2) << time->getDay();
+	ss << " " << std::setw(2) << time->getHour() << ":" << std::setw(2) << time->getMinute();
+	return ss.str();
+}
+
+}
+
+/**
+ * Sets up a geoscape benchmark.
+ * @param game Pointer to the core game, created with a dummy video driver.
+ * @param filename Save file, relative to the master mod user folder.
+ * @param days Number of game days to simulate.
+ * @param seed RNG seed, so runs can be repeated and compared.
+ */
+GeoscapeBenchmark::GeoscapeBenchmark(Game *game, const std::string &filename, int days, uint64_t seed) : _game(game), _filename(filename), _days(days), _seed(seed)
+{
+}
+
+/**
+ *
+ */
+GeoscapeBenchmark::~GeoscapeBenchmark()
+{
+}
+
+/**
+ * Loads the mods and the save, then runs the state machine
+ * as fast as it goes until the days have passed, the campaign
+ * ends, the geoscape stops making progress or a battle drags on.
+ * Nothing is written to disk: ironman and autosaves are turned
+ * off for the run.
+ * The final RNG state is printed along with the timings: two runs
+ * with the same seed must match it.
+ * @return Process exit code, failure if the run got stuck.
+ */
+int GeoscapeBenchmark::run()
+{
+	Log(LOG_INFO) << "Geoscape benchmark: loading data...";
+	Options::updateMods();
+	_game->loadMods();
+	_game->loadLanguages();
+
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(_filename, _game->getMod(), _game->getLanguage());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: " << e.what();
+		delete save;
+		return EXIT_FAILURE;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: " << e.what();
+		delete save;
+		return EXIT_FAILURE;
+	}
+	if (save->getSavedBattle() != 0)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: " << _filename << " is a battlescape save.";
+		delete save;
+		return EXIT_FAILURE;
+	}
+	if (save->getEnding() != END_NONE)
+	{
+		Log(LOG_ERROR) << "Geoscape benchmark: the campaign in " << _filename << " is already over.";
+		delete save;
+		return EXIT_FAILURE;
+	}
+	save->setIronman(false);
+	_game->setSavedGame(save);
+	RNG::setSeed(_seed);
+
+	bool autosave = Options::autosave;
+	Options::autosave = false;
+	Options::baseXResolution = Options::baseXGeoscape;
+	Options::baseYResolution = Options::baseYGeoscape;
+	_game->getScreen()->resetDisplay(false);
+	_game->setState(new GeoscapeState);
+
+	const std::string startDate = dateString(save->getTime());
+	Log(LOG_INFO) << "Geoscape benchmark: simulating " << _days << " days of " << _filename << " from " << startDate << " with seed " << _seed;
+	Timer::fastForward = true;
+	Profiler::setEnabled(true);
+
+	std::set<DogfightState*> orderedDogfights;
+	int days = 0;
+	int lastDay = save->getTime()->getDay();
+	int64_t lastTime = timestamp(save->getTime());
+	Uint64 cycles = 0, idleCycles = 0, battleCycles = 0, popups = 0, battles = 0;
+	SavedBattleGame *lastBattle = 0;
+	std::string stuckIn;
+	auto start = std::chrono::steady_clock::now();
+	while (true)
+	{
+		_game->thinkHeadless();
+		++cycles;
+
+		if (save->getTime()->getDay() != lastDay)
+		{
+			lastDay = save->getTime()->getDay();
+			++days;
+		}
+		State *top = _game->getTopState();
+		// stop before the ending screens take the save away
+		if (top == 0 || days >= _days || save->getEnding() != END_NONE)
+		{
+			break;
+		}
+
+		SavedBattleGame *battle = save->getSavedBattle();
+		if (battle != 0 && battle != lastBattle)
+		{
+			++battles;
+			battleCycles = 0;
+		}
+		lastBattle = battle;
+		int64_t now = timestamp(save->getTime());
+		if (battle != 0)
+		{
+			// the geoscape clock stands still during battles, limit them separately
+			idleCycles = 0;
+			if (battle->getTurn() > STUCK_TURNS || ++battleCycles >= STUCK_BATTLE_CYCLES)
+			{
+				std::ostringstream ss;
+				ss << "battle " << battle->getMissionType() << ", turn " << battle->getTurn() << " after " << battleCycles << " cycles, in " << typeid(*top).name();
+				stuckIn = ss.str();
+				break;
+			}
+		}
+		else if (now != lastTime)
+		{
+			lastTime = now;
+			idleCycles = 0;
+		}
+		else if (++idleCycles >= STUCK_CYCLES)
+		{
+			std::ostringstream ss;
+			ss << "game time did not advance for " << STUCK_CYCLES << " cycles in " << typeid(*top).name();
+			stuckIn = ss.str();
+			break;
+		}
+
+		if (GeoscapeState *geo = dynamic_cast<GeoscapeState*>(top))
+		{
+			geo->timerFastest();
+
+			// interceptions start in standoff, tell each new one to attack once
+			std::set<DogfightState*> current;
+			for (auto* dogfight : geo->getDogfights())
+			{
+				current.insert(dogfight);
+				if (!dogfight->isMinimized() && !dogfight->isUfoAttacking() && orderedDogfights.insert(dogfight).second)
+				{
+					SDL_Event ev;
+					memset(&ev, 0, sizeof(ev));
+					ev.type = SDL_MOUSEBUTTONDOWN;
+					ev.button.button = SDL_BUTTON_LEFT;
+					Action a = Action(&ev, 0.0, 0.0, 0, 0);
+					dogfight->btnStandardSimulateLeftPress(&a);
+				}
+			}
+			for (auto i = orderedDogfights.begin(); i != orderedDogfights.end();)
+			{
+				i = current.count(*i) ? std::next(i) : orderedDogfights.erase(i);
+			}
+		}
+		else if (BattlescapeState *bs = dynamic_cast<BattlescapeState*>(top))
+		{
+			BattlescapeGame *battleGame = bs->getBattleGame();
+			if (battle != 0 && battle->getSide() == FACTION_PLAYER && !battleGame->isBusy())
+			{
+				battleGame->requestEndTurn(false);
+			}
+		}
+		else
+		{
+			// on the geoscape Cancel closes popups without opening other screens
+			// (and turns down landings), in battle OK gets things moving
+			_game->dismissTopState(battle == 0);
+			++popups;
+		}
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	Timer::fastForward = false;
+	Options::autosave = autosave;
+
+	std::ostringstream report;
+	report << "Geoscape benchmark: " << _filename << ", seed " << _seed << std::endl;
+	report << "Simulated " << days << " days, " << startDate << " to " << dateString(save->getTime()) << std::endl;
+	if (save->getEnding() == END_WIN)
+	{
+		report << "Campaign won" << std::endl;
+	}
+	else if (save->getEnding() == END_LOSE)
+	{
+		report << "Campaign lost" << std::endl;
+	}
+	if (!stuckIn.empty())
+	{
+		report << "Stuck: " << stuckIn << std::endl;
+	}
+	report << "Cycles: " << cycles << ", popups: " << popups << ", battles: " << battles << ", wall-clock: " << elapsed / 1000.0 << " ms" << std::endl;
+	report << "Throughput: " << std::fixed << std::setprecision(3) << (elapsed > 0 ? days * 1000000.0 / elapsed : 0.0) << " game days per second" << std::endl;
+	report << "Peak memory: " << std::setprecision(1) << CrossPlatform::getPeakMemoryUsage() / (1024.0 * 1024.0) << " MB" << std::endl;
+	report << "Final RNG state: " << RNG::getSeed() << std::endl;
+	Profiler::report(report);
+	Profiler::setEnabled(false);
+
+	std::cout << report.str();
+	Log(LOG_INFO) << report.str();
+	return stuckIn.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+class Game;
+
+/**
+ * Runs a saved campaign on the geoscape without video, input
+ * or frame pacing, as a soak test and performance benchmark.
+ * Time runs at the fastest speed, popups are closed, dogfights
+ * are fought with standard attacks and battles are played by
+ * ending the player's turns. Throughput, peak memory and the
+ * time spent in each geoscape time handler are reported.
+ */
+class GeoscapeBenchmark
+{
+private:
+	Game *_game;
+	std::string _filename;
+	int _days;
+	uint64_t _seed;
+public:
+	/// Creates a benchmark for a geoscape save.
+	GeoscapeBenchmark(Game *game, const std::string &filename, int days, uint64_t seed);
+	/// Cleans up the benchmark.
+	~GeoscapeBenchmark();
+	/// Loads the save, simulates the days and prints the timings.
+	int run();
+};
+
+}
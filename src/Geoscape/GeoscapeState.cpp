@@ -31,6 +31,7 @@
 #include "../Engine/Sound.h"
 #include "../Engine/Surface.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Engine/Collections.h"
 #include "../Engine/Unicode.h"
 #include "Globe.h"
@@ -834,10 +835,19 @@ void GeoscapeState::timeAdvance()
 	}
 
 
+	int idleTicks = 0, skippedTicks = 0;
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
+		if (trigger == TIME_5SEC && idleTicks > 0)
+		{
+			--idleTicks;
+			++skippedTicks;
+			continue;
+		}
+		skipIdleTicks(skippedTicks);
+		skippedTicks = 0;
 		switch (trigger)
 		{
 		case TIME_1MONTH:
@@ -858,7 +868,12 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+		if (Options::oxceGeoSkipIdleTicks)
+		{
+			idleTicks = countIdleTicks();
+		}
 	}
+	skipIdleTicks(skippedTicks);
 
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
 
@@ -886,12 +901,90 @@ const std::vector<Craft*>* GeoscapeState::updateActiveCrafts()
 	return &_activeCrafts;
 }
 
+/**
+ * Counts how many of the following 5-second ticks would leave
+ * the game unchanged, apart from landed UFOs counting down.
+ * Only call right after time5Seconds(), which brings every idle craft
+ * and UFO to a state where repeating it is a no-op. Nothing here moves,
+ * since stepping a flight analytically would not match the per-tick
+ * integration bit for bit.
+ * @return Number of ticks that can be skipped with skipIdleTicks().
+ */
+int GeoscapeState::countIdleTicks() const
+{
+	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && _game->getMod()->getHunterKillerFastRetarget())
+	{
+		return 0;
+	}
+	const SavedGame *save = _game->getSavedGame();
+	if (save->getBases()->empty() || save->getEnding() == END_LOSE || !_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return 0;
+	}
+
+	int ticks = INT_MAX;
+	for (const auto* ufo : *save->getUfos())
+	{
+		switch (ufo->getStatus())
+		{
+		case Ufo::LANDED:
+			// the tick that empties the timer makes the UFO take off
+			ticks = std::min(ticks, (int)(ufo->getSecondsRemaining() / 5) - 1);
+			break;
+		case Ufo::CRASHED:
+			if (!ufo->getDetected())
+			{
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+	}
+	for (const auto* base : *save->getBases())
+	{
+		for (const auto* craft : *base->getCrafts())
+		{
+			if (craft->isDestroyed() || craft->getDestination() != 0 || craft->getTakeoff() != 0)
+			{
+				return 0;
+			}
+			if (craft->getShield() < craft->getCraftStats().shieldCapacity && craft->getCraftStats().shieldRechargeInGeoscape != 0)
+			{
+				return 0;
+			}
+		}
+	}
+	return std::max(ticks, 0);
+}
+
+/**
+ * Applies what the given number of idle 5-second ticks
+ * would have done, see countIdleTicks().
+ * @param ticks Number of skipped ticks.
+ */
+void GeoscapeState::skipIdleTicks(int ticks)
+{
+	if (ticks <= 0)
+	{
+		return;
+	}
+	for (auto* ufo : *_game->getSavedGame()->getUfos())
+	{
+		if (ufo->getStatus() == Ufo::LANDED)
+		{
+			ufo->setSecondsRemaining(ufo->getSecondsRemaining() - 5 * ticks);
+		}
+	}
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
  */
 void GeoscapeState::time5Seconds()
 {
+	Profiler::Scope profile(PROF_TIME_5SEC);
 	// If in "slow mode", handle UFO hunting and escorting logic every 5 seconds, not only every 10 minutes
 	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && _game->getMod()->getHunterKillerFastRetarget())
 	{
@@ -1465,6 +1558,7 @@ struct SetRetaliationTarget
  */
 void GeoscapeState::time10Minutes()
 {
+	Profiler::Scope profile(PROF_TIME_10MIN);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		// Fuel consumption for XCOM craft.
@@ -1768,6 +1862,7 @@ bool GeoscapeState::processMissionSite(MissionSite *site)
  */
 void GeoscapeState::time30Minutes()
 {
+	Profiler::Scope profile(PROF_TIME_30MIN);
 	// Decrease mission countdowns
 	for (auto am : _game->getSavedGame()->getAlienMissions())
 	{
@@ -2031,6 +2126,7 @@ void GeoscapeState::time30Minutes()
  */
 void GeoscapeState::time1Hour()
 {
+	Profiler::Scope profile(PROF_TIME_1HOUR);
 	// Handle craft maintenance
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
@@ -2239,6 +2335,7 @@ void GenerateSupplyMission::operator()(AlienBase *base) const
  */
 void GeoscapeState::time1Day()
 {
+	Profiler::Scope profile(PROF_TIME_1DAY);
 	SavedGame *saveGame = _game->getSavedGame();
 	Mod *mod = _game->getMod();
 	bool psiStrengthEval = (Options::psiStrengthEval && saveGame->isResearched(mod->getPsiRequirements()));
@@ -2691,6 +2788,7 @@ void GeoscapeState::time1Day()
  */
 void GeoscapeState::time1Month()
 {
+	Profiler::Scope profile(PROF_TIME_1MONTH);
 	_game->getSavedGame()->addMonth();
 
 	// Determine alien mission for this month.
@@ -2748,6 +2846,18 @@ void GeoscapeState::timerReset()
 	_btn5Secs->mousePress(&act, this);
 }
 
+/**
+ * Speeds up the timer to 1 day steps, for when
+ * the campaign is simulated without a player.
+ */
+void GeoscapeState::timerFastest()
+{
+	SDL_Event ev;
+	ev.button.button = SDL_BUTTON_LEFT;
+	Action act(&ev, _game->getScreen()->getXScale(), _game->getScreen()->getYScale(), _game->getScreen()->getCursorTopBlackBand(), _game->getScreen()->getCursorLeftBlackBand());
+	_btn1Day->mousePress(&act, this);
+}
+
 /**
  * Adds a new popup window to the queue
  * (this prevents popups from overlapping)
@@ -3177,6 +3287,16 @@ void GeoscapeState::handleDogfightMultiAction(int button)
 	}
 }
 
+/**
+ * Gets the dogfights that are currently running,
+ * minimized or not.
+ * @return List of dogfights.
+ */
+const std::list<DogfightState*> &GeoscapeState::getDogfights() const
+{
+	return _dogfights;
+}
+
 /**
  * Goes through all dogfight instances and tries to award pilot experience.
  * This is called each time any UFO takes any damage in dogfight... very ugly, but I couldn't find a better place for it.
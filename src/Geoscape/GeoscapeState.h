@@ -65,6 +65,10 @@ private:
 
 	/// Update list of active crafts.
 	const std::vector<Craft*>* updateActiveCrafts();
+	/// Counts the upcoming 5-second ticks that cannot change anything.
+	int countIdleTicks() const;
+	/// Applies the effect of skipped idle ticks.
+	void skipIdleTicks(int ticks);
 
 	void cbxRegionChange(Action *action);
 	void cbxZoneChange(Action *action);
@@ -100,6 +104,8 @@ public:
 	void time1Month();
 	/// Resets the timer to minimum speed.
 	void timerReset();
+	/// Sets the timer to maximum speed.
+	void timerFastest();
 	/// Displays a popup window.
 	void popup(State *state);
 	/// Gets the Geoscape globe.
@@ -163,6 +169,8 @@ public:
 	/// Multi-dogfights logic handling.
 	void handleDogfights();
 	void handleDogfightMultiAction(int button);
+	/// Gets the running dogfights.
+	const std::list<DogfightState*> &getDogfights() const;
 	/// Dogfight experience handling.
 	void handleDogfightExperience();
 	/// Gets the number of minimized dogfights.
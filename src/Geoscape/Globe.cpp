@@ -56,11 +56,22 @@
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
 
+#if (_MSC_VER >= 1400) || (defined(__MINGW32__) && defined(__SSE2__))
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace OpenXcom
 {
 
 const double Globe::ROTATE_LONGITUDE = 0.10;
 const double Globe::ROTATE_LATITUDE = 0.06;
+const double Globe::SHADOW_SUN_STEP = 0.001;
 
 Uint8 Globe::OCEAN_COLOR;
 bool Globe::OCEAN_SHADING;
@@ -235,7 +246,7 @@ struct Ocean
 
 struct CreateShadow
 {
-	static inline Uint8 getShadowValue(const Cord& earth, const Cord& sun, const Sint16& noise)
+	static inline double getShadowDistance(const Cord& earth, const Cord& sun, const Sint16& noise)
 	{
 		Cord temp = earth;
 		//diff
@@ -255,8 +266,37 @@ struct CreateShadow
 		//random noise than increase with distance from middle of twilight
 		temp.x += static_data.getMultiplierNoise(noise) * 4 * (temp.x - GlobeStaticData::shade_gradient_max / 2) / GlobeStaticData::shade_gradient_max;
 
+		return temp.x;
+	}
+
+#ifdef __SSE2__
+	/**
+	 * Same as `getShadowDistance` but for two pixels at once,
+	 * every operation is done in same order to get bit identical results.
+	 */
+	static inline void getShadowDistance2(const Cord* earth, const Cord& sun, const Sint16* noise, double* distance)
+	{
+		const __m128d x = _mm_sub_pd(_mm_set_pd(earth[1].x, earth[0].x), _mm_set1_pd(sun.x));
+		const __m128d y = _mm_sub_pd(_mm_set_pd(earth[1].y, earth[0].y), _mm_set1_pd(sun.y));
+		const __m128d z = _mm_sub_pd(_mm_set_pd(earth[1].z, earth[0].z), _mm_set1_pd(sun.z));
+		__m128d temp = _mm_add_pd(_mm_mul_pd(x, x), _mm_add_pd(_mm_mul_pd(z, z), _mm_mul_pd(y, y)));
+
+		const __m128d middle = _mm_set1_pd(GlobeStaticData::shade_gradient_max / 2);
+		temp = _mm_sub_pd(temp, _mm_set1_pd(2));
+		temp = _mm_mul_pd(temp, _mm_set1_pd(125.));
+		temp = _mm_add_pd(temp, middle);
+		temp = _mm_sub_pd(temp, _mm_set_pd(static_data.getDistanceNoise(noise[1]), static_data.getDistanceNoise(noise[0])));
+		const __m128d multiplier = _mm_set_pd(static_data.getMultiplierNoise(noise[1]) * 4, static_data.getMultiplierNoise(noise[0]) * 4);
+		temp = _mm_add_pd(temp, _mm_div_pd(_mm_mul_pd(multiplier, _mm_sub_pd(temp, middle)), _mm_set1_pd(GlobeStaticData::shade_gradient_max)));
+
+		_mm_storeu_pd(distance, temp);
+	}
+#endif
+
+	static inline Uint8 getShadowValue(const double& distance, const Sint16& noise)
+	{
 		double full = 0;
-		double rem = std::modf(temp.x, &full);
+		double rem = std::modf(distance, &full);
 		int offset = Clamp((int)full, 0, GlobeStaticData::shade_gradient_max - 1);
 		int i = static_data.shade_gradient[offset];
 
@@ -267,6 +307,11 @@ struct CreateShadow
 		return Clamp(i, 0, 31);
 	}
 
+	static inline Uint8 getShadowValue(const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		return getShadowValue(getShadowDistance(earth, sun, noise), noise);
+	}
+
 	static inline Uint8 getOceanShadow(const Uint8& shadow)
 	{
 		return Globe::OCEAN_COLOR + shadow;
@@ -288,11 +333,11 @@ struct CreateShadow
 		return Globe::OCEAN_SHADING && dest >= Globe::OCEAN_COLOR && dest < Globe::OCEAN_COLOR + 32;
 	}
 
-	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	static inline void applyShadow(Uint8& dest, const Cord& earth, const double& distance, const Sint16& noise)
 	{
 		if (dest && earth.z)
 		{
-			const Uint8 shadow = getShadowValue(earth, sun, noise);
+			const Uint8 shadow = getShadowValue(distance, noise);
 			//this pixel is ocean
 			if (isOcean(dest))
 			{
@@ -309,6 +354,46 @@ struct CreateShadow
 			dest = 0;
 		}
 	}
+
+	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		applyShadow(dest, earth, (dest && earth.z) ? getShadowDistance(earth, sun, noise) : 0.0, noise);
+	}
+
+	/**
+	 * Same as `func` but for whole row of pixels.
+	 * Noise surface repeats, rest of row is read from same row of noise and wraps on its edge.
+	 */
+	static inline void funcRow(int size, Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		Uint8* destRow = &dest;
+		const Cord* earthRow = &earth;
+		const int noiseIndex = &noise - static_data.random_noise;
+		const Sint16* noiseRow = static_data.random_noise + (noiseIndex - noiseIndex % GlobeStaticData::random_surf_size);
+		int noiseX = noiseIndex % GlobeStaticData::random_surf_size;
+
+		int i = 0;
+#ifdef __SSE2__
+		for (; i + 2 <= size; i += 2)
+		{
+			Sint16 noisePair[2];
+			double distance[2];
+			noisePair[0] = noiseRow[noiseX];
+			if (++noiseX == GlobeStaticData::random_surf_size) noiseX = 0;
+			noisePair[1] = noiseRow[noiseX];
+			if (++noiseX == GlobeStaticData::random_surf_size) noiseX = 0;
+
+			getShadowDistance2(earthRow + i, sun, noisePair, distance);
+			applyShadow(destRow[i], earthRow[i], distance[0], noisePair[0]);
+			applyShadow(destRow[i + 1], earthRow[i + 1], distance[1], noisePair[1]);
+		}
+#endif
+		for (; i < size; ++i)
+		{
+			func(destRow[i], earthRow[i], sun, noiseRow[noiseX]);
+			if (++noiseX == GlobeStaticData::random_surf_size) noiseX = 0;
+		}
+	}
 };
 
 }//namespace
@@ -325,7 +410,7 @@ struct CreateShadow
  * @param y Y position in pixels.
  */
 Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenX(cenX), _cenY(cenY), _rotLon(0.0), _rotLat(0.0), _hoverLon(0.0), _hoverLat(0.0), _craftLon(0.0), _craftLat(0.0), _craftRange(0.0), _game(game), _hover(false), _craft(false), _blink(-1),
-																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false)
+																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false), _shadowValid(false)
 {
 	_rules = game->getMod()->getGlobe();
 	_texture = new SurfaceSet(*_game->getMod()->getSurfaceSet("TEXTURE.DAT"));
@@ -334,6 +419,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	_countries = new Surface(width, height, x, y);
 	_markers = new Surface(width, height, x, y);
 	_radars = new Surface(width, height, x, y);
+	_landCache = new Surface(width, height, x, y);
 	_clipper = new FastLineClip(x, x+width, y, y+height);
 
 	// Animation timers
@@ -365,6 +451,7 @@ Globe::~Globe()
 	delete _markers;
 	delete _texture;
 	delete _radars;
+	delete _landCache;
 	delete _clipper;
 
 	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
@@ -447,46 +534,7 @@ bool Globe::pointBack(double lon, double lat) const
 
 Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 {
-	const double zDiscard=0.75f;
-	double coslat = cos(lat);
-	double sinlat = sin(lat);
-
-	for (std::list<Polygon*>::iterator i = _rules->getPolygons()->begin(); i != _rules->getPolygons()->end(); ++i)
-	{
-		double x, y, z, x2, y2;
-		double clat, clon;
-		z = 0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			z = coslat * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - lon) + sinlat * sin((*i)->getLatitude(j));
-			if (z<zDiscard) break; //discarded
-		}
-		if (z<zDiscard) continue; //discarded
-
-		bool odd = false;
-
-		clat = (*i)->getLatitude(0); //initial point
-		clon = (*i)->getLongitude(0);
-		x = cos(clat) * sin(clon - lon);
-		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			int k = (j + 1) % (*i)->getPoints(); //index of next point in poly
-			clat = (*i)->getLatitude(k);
-			clon = (*i)->getLongitude(k);
-
-			x2 = cos(clat) * sin(clon - lon);
-			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
-				odd = !odd;
-			x = x2;
-			y = y2;
-
-		}
-		if (odd) return *i;
-	}
-	return NULL;
+	return _rules->getPolygonFromLonLat(lon, lat);
 }
 
 /**
@@ -897,6 +945,7 @@ void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
 void Globe::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
+	_landCache->setPalette(colors, firstcolor, ncolors);
 
 	_texture->setPalette(colors, firstcolor, ncolors);
 
@@ -940,19 +989,37 @@ void Globe::rotate()
 
 /**
  * Draws the whole globe, part by part.
+ * Ocean and land only change when the globe is moved and the shadow
+ * only when the sun moves noticeably, so both are kept between redraws
+ * and only the overlays are redrawn on every time step.
  */
 void Globe::draw()
 {
-	if (_redraw)
+	bool shadowValid = _shadowValid;
+	if (_redraw || !_shadowValid)
 	{
 		cachePolygons();
+		Surface::draw();
+		drawOcean();
+		drawLand();
+		_landCache->copy(this);
+		shadowValid = false;
 	}
-	Surface::draw();
-	drawOcean();
-	drawLand();
 	drawRadars();
 	drawFlights();
-	drawShadow();
+	const Cord sun = getSunDirection(_cenLon, _cenLat);
+	Cord sunMove = sun;
+	sunMove -= _shadowSun;
+	if (!shadowValid || std::abs(sunMove.x) > SHADOW_SUN_STEP || std::abs(sunMove.y) > SHADOW_SUN_STEP || std::abs(sunMove.z) > SHADOW_SUN_STEP)
+	{
+		if (shadowValid)
+		{
+			copy(_landCache);
+		}
+		drawShadow(sun);
+		_shadowSun = sun;
+		_shadowValid = true;
+	}
 	drawMarkers();
 	drawDetail();
 }
@@ -1050,17 +1117,51 @@ Cord Globe::getSunDirection(double lon, double lat) const
 }
 
 
-void Globe::drawShadow()
+/**
+ * Draws the shadow of the globe.
+ * @param sun Direction of the sun.
+ */
+void Globe::drawShadow(const Cord& sun)
+{
+	lock();
+	drawShadow(SurfaceRaw<Uint8>(this), SurfaceRaw<Cord>(_earthData[_zoom], getWidth(), getHeight()), _cenX-getWidth()/2, _cenY-getHeight()/2, sun, true);
+	unlock();
+}
+
+/**
+ * Draws the shadow of a globe on a raw surface.
+ * @param dest Surface with the drawn globe.
+ * @param earthData Normal vectors of the globe surface.
+ * @param moveX Horizontal offset of the globe.
+ * @param moveY Vertical offset of the globe.
+ * @param sun Direction of the sun.
+ * @param rows Process whole rows with vector instructions, otherwise go pixel by pixel.
+ */
+void Globe::drawShadow(SurfaceRaw<Uint8> dest, SurfaceRaw<Cord> earthData, int moveX, int moveY, const Cord& sun, bool rows)
 {
-	auto earth = ShaderMove<Cord>(SurfaceRaw<Cord>(_earthData[_zoom], getWidth(), getHeight()));
+	auto earth = ShaderMove<Cord>(earthData);
 	auto noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
 
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
-
-	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
-	unlock();
+	earth.setMove(moveX, moveY);
 
+	if (rows)
+	{
+		// noise repeats so `ShaderDraw` would go pixel by pixel, `CreateShadow::funcRow` handles wrapping by itself
+		ShaderDrawRowImpl(
+			[](int size, Uint8& d, const Cord& e, const Cord& s, const Sint16& n)
+			{
+				CreateShadow::funcRow(size, d, e, s, n);
+			},
+			helper::controler<ShaderMove<Uint8>>(ShaderSurface(dest)),
+			helper::controler<ShaderMove<Cord>>(earth),
+			helper::controler<helper::Scalar<const Cord>>(ShaderScalar(sun)),
+			helper::controler<ShaderRepeat<Sint16>>(noise)
+		);
+	}
+	else
+	{
+		ShaderDraw<CreateShadow>(ShaderSurface(dest), earth, ShaderScalar(sun), noise);
+	}
 }
 
 
@@ -1269,7 +1370,7 @@ void Globe::drawGlobeCircle(double lat, double lon, double radius, int segments,
 			continue;
 		}
 		if (!pointBack(lon1,lat1) && i % frac == 0)
-			XuLine(_radars, this, x, y, x2, y2, 6);
+			XuLine(_radars, _landCache, x, y, x2, y2, 6);
 		x2=x; y2=y;
 		i++;
 	}
@@ -1597,7 +1698,7 @@ void Globe::drawPath(Surface *surface, double lon1, double lat1, double lon2, do
 
 		if (!pointBack(p1.lon, p1.lat) && !pointBack(p2.lon, p2.lat))
 		{
-			XuLine(surface, this, x1, y1, x2, y2, 8);
+			XuLine(surface, _landCache, x1, y1, x2, y2, 8);
 		}
 
 		p1 = p2;
@@ -2041,11 +2142,11 @@ void Globe::toggleRadarLines()
  */
 void Globe::resize()
 {
-	Surface *surfaces[4] = {this, _markers, _countries, _radars};
+	Surface *surfaces[5] = {this, _markers, _countries, _radars, _landCache};
 	int width = Options::baseXGeoscape - 64;
 	int height = Options::baseYGeoscape;
 
-	for (int i = 0; i < 4; ++i)
+	for (int i = 0; i < 5; ++i)
 	{
 		surfaces[i]->setWidth(width);
 		surfaces[i]->setHeight(height);
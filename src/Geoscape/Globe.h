@@ -52,6 +52,8 @@ private:
 	static const int CITY_MARKER = 8;
 	static const double ROTATE_LONGITUDE;
 	static const double ROTATE_LATITUDE;
+	/// How far the sun can move before the cached shadow is redrawn.
+	static const double SHADOW_SUN_STEP;
 
 	RuleGlobe *_rules;
 	Sint16 _cenX, _cenY;
@@ -78,6 +80,11 @@ private:
 	Uint32 _mouseScrollingStartTime;
 	int _totalMouseMoveX, _totalMouseMoveY;
 	bool _mouseMovedOverThreshold;
+	/// Ocean and land without shadow, kept until the globe moves.
+	Surface *_landCache;
+	/// Sun direction of the currently drawn shadow.
+	Cord _shadowSun;
+	bool _shadowValid;
 
 	/// Sets the globe zoom factor.
 	void setZoom(size_t zoom);
@@ -178,7 +185,9 @@ public:
 	/// Draws the land of the globe.
 	void drawLand();
 	/// Draws the shadow.
-	void drawShadow();
+	void drawShadow(const Cord& sun);
+	/// Draws the shadow of a globe on a raw surface.
+	static void drawShadow(SurfaceRaw<Uint8> dest, SurfaceRaw<Cord> earthData, int moveX, int moveY, const Cord& sun, bool rows);
 	/// Draws the radar ranges of the globe.
 	void drawRadars();
 	/// Draws the flight paths of the globe.
@@ -34,7 +34,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0), _frameTime(0.0)
 {
 	_visible = Options::fpsCounter;
 
@@ -42,7 +42,8 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 	_timer->onTimer((SurfaceHandler)&FpsCounter::update);
 	_timer->start();
 
-	_text = new NumberText(width, height, x, y);
+	_text = new NumberText(width, height / 2, x, y);
+	_frameTimeText = new NumberText(width, height / 2, x, y + height - height / 2);
 }
 
 /**
@@ -51,6 +52,7 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 FpsCounter::~FpsCounter()
 {
 	delete _text;
+	delete _frameTimeText;
 	delete _timer;
 }
 
@@ -64,6 +66,7 @@ void FpsCounter::setPalette(const SDL_Color *colors, int firstcolor, int ncolors
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
 	_text->setPalette(colors, firstcolor, ncolors);
+	_frameTimeText->setPalette(colors, firstcolor, ncolors);
 }
 
 /**
@@ -73,6 +76,7 @@ void FpsCounter::setPalette(const SDL_Color *colors, int firstcolor, int ncolors
 void FpsCounter::setColor(Uint8 color)
 {
 	_text->setColor(color);
+	_frameTimeText->setColor(color);
 }
 
 /**
@@ -97,13 +101,16 @@ void FpsCounter::think()
 }
 
 /**
- * Updates the amount of Frames per Second.
+ * Updates the amount of Frames per Second
+ * and the average time to put them on screen.
  */
 void FpsCounter::update()
 {
 	int fps = (int)floor((double)_frames / _timer->getTime() * 1000);
 	_text->setValue(fps);
+	_frameTimeText->setValue(_frames > 0 ? (unsigned int)(_frameTime / _frames) : 0);
 	_frames = 0;
+	_frameTime = 0.0;
 	_redraw = true;
 }
 
@@ -114,6 +121,7 @@ void FpsCounter::draw()
 {
 	Surface::draw();
 	_text->blit(this->getSurface());
+	_frameTimeText->blit(this->getSurface());
 }
 
 void FpsCounter::addFrame()
@@ -121,4 +129,14 @@ void FpsCounter::addFrame()
 	_frames++;
 }
 
+/**
+ * Adds the time it took to put a frame on screen,
+ * to be averaged over the frames of the last second.
+ * @param time Time in microseconds.
+ */
+void FpsCounter::addFrameTime(double time)
+{
+	_frameTime += time;
+}
+
 }
@@ -28,14 +28,17 @@ class Action;
 
 /**
  * Counts the amount of frames each second
- * and displays them in a NumberText surface.
+ * and displays them in a NumberText surface,
+ * along with how long it takes to put a frame
+ * on screen (in microseconds).
  */
 class FpsCounter : public Surface
 {
 private:
-	NumberText *_text;
+	NumberText *_text, *_frameTimeText;
 	Timer *_timer;
 	int _frames;
+	double _frameTime;
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -54,6 +57,8 @@ public:
 	/// Draws the FPS counter.
 	void draw() override;
 	void addFrame();
+	/// Adds the time it took to put a frame on screen.
+	void addFrameTime(double time);
 };
 
 }
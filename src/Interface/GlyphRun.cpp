@@ -0,0 +1,283 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GlyphRun.h"
+#include <functional>
+#include <unordered_map>
+#include "../Engine/Font.h"
+#include "../Engine/Language.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Everything the layout of a text depends on.
+ */
+struct GlyphRunKey
+{
+	std::string text;
+	Font *big, *small, *font;
+	int wrapping, width;
+	bool wrap, indent, ignoreSeparators;
+
+	bool operator==(const GlyphRunKey &other) const
+	{
+		return big == other.big && small == other.small && font == other.font &&
+			wrapping == other.wrapping && width == other.width &&
+			wrap == other.wrap && indent == other.indent && ignoreSeparators == other.ignoreSeparators &&
+			text == other.text;
+	}
+};
+
+struct GlyphRunKeyHash
+{
+	size_t operator()(const GlyphRunKey &key) const
+	{
+		size_t h = std::hash<std::string>()(key.text);
+		auto combine = [&](size_t v) { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); };
+		combine(std::hash<const void*>()(key.big));
+		combine(std::hash<const void*>()(key.small));
+		combine(std::hash<const void*>()(key.font));
+		combine(key.wrapping);
+		combine(key.width);
+		combine(key.wrap | (key.indent << 1) | (key.ignoreSeparators << 2));
+		return h;
+	}
+};
+
+std::unordered_map<GlyphRunKey, std::shared_ptr<const GlyphRun>, GlyphRunKeyHash> runs;
+
+/**
+ * Converts the text to codepoints, adds the wordwrap line breaks
+ * and calculates the line metrics for alignment.
+ * @param key Text and layout settings.
+ * @param run Run to fill.
+ */
+void layoutText(const GlyphRunKey &key, GlyphRun &run)
+{
+	run.text = Unicode::convUtf8ToUtf32(key.text);
+
+	int width = 0, word = 0;
+	size_t space = 0, textIndentation = 0;
+	bool start = true;
+	Font *font = key.font;
+	UString &str = run.text;
+
+	// Go through the text character by character
+	for (size_t c = 0; c <= str.size(); ++c)
+	{
+		// End of the line
+		if (c == str.size() || Unicode::isLinebreak(str[c]))
+		{
+			// Add line measurements for alignment later
+			run.lineWidth.push_back(width);
+			run.lineHeight.push_back(font->getCharSize('\n').h);
+			width = 0;
+			word = 0;
+			start = true;
+
+			if (c == str.size())
+				break;
+			else if (str[c] == Unicode::TOK_NL_SMALL)
+				font = key.small;
+		}
+		// Keep track of spaces for wordwrapping
+		else if (Unicode::isSpace(str[c]) || (!key.ignoreSeparators && Unicode::isSeparator(str[c])))
+		{
+			// Store existing indentation
+			if (c == textIndentation)
+			{
+				textIndentation++;
+			}
+			space = c;
+			width += font->getCharSize(str[c]).w;
+			word = 0;
+			start = false;
+		}
+		// Keep track of the width of the last line and word
+		else if (str[c] != Unicode::TOK_COLOR_FLIP)
+		{
+			int charWidth = font->getCharSize(str[c]).w;
+
+			width += charWidth;
+			word += charWidth;
+
+			// Wordwrap if the last word doesn't fit the line
+			if (key.wrap && width >= key.width && (!start || key.wrapping == WRAP_LETTERS))
+			{
+				size_t indentLocation = c;
+				if (key.wrapping == WRAP_WORDS || Unicode::isSpace(str[c]))
+				{
+					// Go back to the last space and put a linebreak there
+					width -= word;
+					indentLocation = space;
+					if (Unicode::isSpace(str[space]))
+					{
+						width -= font->getCharSize(str[space]).w;
+						str[space] = '\n';
+					}
+					else
+					{
+						str.insert(space+1, 1, '\n');
+						indentLocation++;
+					}
+				}
+				else if (key.wrapping == WRAP_LETTERS)
+				{
+					// Go back to the last letter and put a linebreak there
+					str.insert(c, 1, '\n');
+					width -= charWidth;
+				}
+
+				// Keep initial indentation of text
+				if (textIndentation > 0)
+				{
+					str.insert(indentLocation+1, textIndentation, '\t');
+					indentLocation += textIndentation;
+				}
+				// Indent due to word wrap.
+				if (key.indent)
+				{
+					str.insert(indentLocation+1, 1, '\t');
+					width += font->getCharSize('\t').w;
+				}
+
+				run.lineWidth.push_back(width);
+				run.lineHeight.push_back(font->getCharSize('\n').h);
+				if (key.wrapping == WRAP_WORDS)
+				{
+					width = word;
+				}
+				else if (key.wrapping == WRAP_LETTERS)
+				{
+					width = 0;
+				}
+				start = true;
+			}
+		}
+	}
+}
+
+/**
+ * Places every drawn character of the laid out text,
+ * following the same rules as drawing it one by one.
+ * @param key Text and layout settings.
+ * @param run Run to fill.
+ */
+void placeGlyphs(const GlyphRunKey &key, GlyphRun &run)
+{
+	int offset = 0, y = 0, line = 0;
+	bool flip = false;
+	Font *font = key.font;
+
+	for (UString::const_iterator c = run.text.begin(); c != run.text.end(); ++c)
+	{
+		if (Unicode::isSpace(*c) || *c == '\t')
+		{
+			offset += font->getCharSize(*c).w;
+		}
+		else if (Unicode::isLinebreak(*c))
+		{
+			line++;
+			y += font->getCharSize(*c).h;
+			offset = 0;
+			if (*c == Unicode::TOK_NL_SMALL)
+			{
+				font = key.small;
+			}
+		}
+		else if (*c == Unicode::TOK_COLOR_FLIP)
+		{
+			flip = !flip;
+		}
+		else
+		{
+			Glyph glyph;
+			glyph.chr = font->getChar(*c);
+			glyph.line = line;
+			glyph.offset = offset;
+			glyph.width = font->getCharSize(*c).w;
+			glyph.y = y;
+			glyph.flip = flip;
+			run.glyphs.push_back(glyph);
+			offset += glyph.width;
+		}
+	}
+}
+
+} //namespace
+
+/**
+ * Returns the glyph run of a text, laying it out
+ * the first time the combination is used.
+ * @param text Text string.
+ * @param big Large-size font.
+ * @param small Small-size font.
+ * @param font Font the text starts with.
+ * @param wrapping Wordwrap mode of the language.
+ * @param wrap Is wordwrap enabled.
+ * @param width Width available for wordwrap.
+ * @param indent Are wrapped lines indented.
+ * @param ignoreSeparators Are separators ignored for wordwrap.
+ * @return Shared glyph run.
+ */
+std::shared_ptr<const GlyphRun> GlyphRunCache::get(const std::string &text, Font *big, Font *small, Font *font, int wrapping, bool wrap, int width, bool indent, bool ignoreSeparators)
+{
+	GlyphRunKey key;
+	key.text = text;
+	key.big = big;
+	key.small = small;
+	key.font = font;
+	key.wrapping = wrapping;
+	// the width only matters when wrapping
+	key.width = wrap ? width : 0;
+	key.wrap = wrap;
+	key.indent = indent;
+	key.ignoreSeparators = ignoreSeparators;
+
+	auto i = runs.find(key);
+	if (i != runs.end())
+	{
+		return i->second;
+	}
+
+	auto run = std::make_shared<GlyphRun>();
+	layoutText(key, *run);
+	placeGlyphs(key, *run);
+
+	if (runs.size() >= MAX_RUNS)
+	{
+		runs.clear();
+	}
+	runs.emplace(std::move(key), run);
+	return run;
+}
+
+/**
+ * Drops all the cached glyph runs, needed when the fonts go away.
+ * Texts keep the runs they are already using.
+ */
+void GlyphRunCache::clear()
+{
+	runs.clear();
+}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Engine/Surface.h"
+#include "../Engine/Unicode.h"
+
+namespace OpenXcom
+{
+
+class Font;
+
+/**
+ * A character of a glyph run, with its position
+ * relative to the start of its line.
+ */
+struct Glyph
+{
+	/// Image of the character in the font.
+	SurfaceCrop chr;
+	/// Line of the character.
+	int line;
+	/// Distance from the start of the line, before alignment.
+	int offset;
+	/// Horizontal advance of the character.
+	int width;
+	/// Distance from the top of the text.
+	int y;
+	/// Is the character drawn with the secondary color.
+	bool flip;
+};
+
+/**
+ * Text laid out for a given set of fonts and wordwrap settings.
+ * Alignment and colors are not part of the run, so the same run
+ * is shared by every text showing the same string in the same space.
+ */
+struct GlyphRun
+{
+	/// Text with the wordwrap line breaks added.
+	UString text;
+	/// Line metrics for alignment.
+	std::vector<int> lineWidth, lineHeight;
+	/// Every drawn character, in text order.
+	std::vector<Glyph> glyphs;
+};
+
+/**
+ * Keeps the glyph runs of recently used strings so texts
+ * don't have to measure every character again each time
+ * they are set up or drawn.
+ */
+class GlyphRunCache
+{
+public:
+	/// Maximum number of runs kept before the cache is emptied.
+	static const size_t MAX_RUNS = 4096;
+
+	/// Gets the glyph run for a text, laying it out if necessary.
+	static std::shared_ptr<const GlyphRun> get(const std::string &text, Font *big, Font *small, Font *font, int wrapping, bool wrap, int width, bool indent, bool ignoreSeparators);
+	/// Drops all cached runs.
+	static void clear();
+};
+
+}
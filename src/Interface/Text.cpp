@@ -18,6 +18,7 @@
  */
 #include "Text.h"
 #include <cmath>
+#include "GlyphRun.h"
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
 #include "../Engine/Language.h"
@@ -244,7 +245,7 @@ Uint8 Text::getSecondaryColor() const
 
 int Text::getNumLines() const
 {
-	return _wrap ? _lineHeight.size() : 1;
+	return _wrap && _run ? _run->lineHeight.size() : 1;
 }
 
 /**
@@ -257,15 +258,18 @@ int Text::getTextHeight(int line) const
 	if (line == -1)
 	{
 		int height = 0;
-		for (std::vector<int>::const_iterator i = _lineHeight.begin(); i != _lineHeight.end(); ++i)
+		if (_run)
 		{
-			height += *i;
+			for (std::vector<int>::const_iterator i = _run->lineHeight.begin(); i != _run->lineHeight.end(); ++i)
+			{
+				height += *i;
+			}
 		}
 		return height;
 	}
 	else
 	{
-		return _lineHeight[line];
+		return _run->lineHeight[line];
 	}
 }
 
@@ -279,18 +283,21 @@ int Text::getTextWidth(int line) const
 	if (line == -1)
 	{
 		int width = 0;
-		for (std::vector<int>::const_iterator i = _lineWidth.begin(); i != _lineWidth.end(); ++i)
+		if (_run)
 		{
-			if (*i > width)
+			for (std::vector<int>::const_iterator i = _run->lineWidth.begin(); i != _run->lineWidth.end(); ++i)
 			{
-				width = *i;
+				if (*i > width)
+				{
+					width = *i;
+				}
 			}
 		}
 		return width;
 	}
 	else
 	{
-		return _lineWidth[line];
+		return _run->lineWidth[line];
 	}
 }
 
@@ -298,6 +305,7 @@ int Text::getTextWidth(int line) const
  * Takes care of any text post-processing like converting
  * encoded text to individual codepoints and calculating
  * line metrics for alignment and wordwrapping.
+ * Texts with the same string and layout share the result.
  */
 void Text::processText()
 {
@@ -306,110 +314,7 @@ void Text::processText()
 		return;
 	}
 
-	_processedText = Unicode::convUtf8ToUtf32(_text);
-	_lineWidth.clear();
-	_lineHeight.clear();
-
-	int width = 0, word = 0;
-	size_t space = 0, textIndentation = 0;
-	bool start = true;
-	Font *font = _font;
-	UString &str = _processedText;
-
-	// Go through the text character by character
-	for (size_t c = 0; c <= str.size(); ++c)
-	{
-		// End of the line
-		if (c == str.size() || Unicode::isLinebreak(str[c]))
-		{
-			// Add line measurements for alignment later
-			_lineWidth.push_back(width);
-			_lineHeight.push_back(font->getCharSize('\n').h);
-			width = 0;
-			word = 0;
-			start = true;
-
-			if (c == str.size())
-				break;
-			else if (str[c] == Unicode::TOK_NL_SMALL)
-				font = _small;
-		}
-		// Keep track of spaces for wordwrapping
-		else if (Unicode::isSpace(str[c]) || (!_ignoreSeparators && Unicode::isSeparator(str[c])))
-		{
-			// Store existing indentation
-			if (c == textIndentation)
-			{
-				textIndentation++;
-			}
-			space = c;
-			width += font->getCharSize(str[c]).w;
-			word = 0;
-			start = false;
-		}
-		// Keep track of the width of the last line and word
-		else if (str[c] != Unicode::TOK_COLOR_FLIP)
-		{
-			int charWidth = font->getCharSize(str[c]).w;
-
-			width += charWidth;
-			word += charWidth;
-
-			// Wordwrap if the last word doesn't fit the line
-			if (_wrap && width >= getWidth() && (!start || _lang->getTextWrapping() == WRAP_LETTERS))
-			{
-				size_t indentLocation = c;
-				if (_lang->getTextWrapping() == WRAP_WORDS || Unicode::isSpace(str[c]))
-				{
-					// Go back to the last space and put a linebreak there
-					width -= word;
-					indentLocation = space;
-					if (Unicode::isSpace(str[space]))
-					{
-						width -= font->getCharSize(str[space]).w;
-						str[space] = '\n';
-					}
-					else
-					{
-						str.insert(space+1, 1, '\n');
-						indentLocation++;
-					}
-				}
-				else if (_lang->getTextWrapping() == WRAP_LETTERS)
-				{
-					// Go back to the last letter and put a linebreak there
-					str.insert(c, 1, '\n');
-					width -= charWidth;
-				}
-
-				// Keep initial indentation of text
-				if (textIndentation > 0)
-				{
-					str.insert(indentLocation+1, textIndentation, '\t');
-					indentLocation += textIndentation;
-				}
-				// Indent due to word wrap.
-				if (_indent)
-				{
-					str.insert(indentLocation+1, 1, '\t');
-					width += font->getCharSize('\t').w;
-				}
-
-				_lineWidth.push_back(width);
-				_lineHeight.push_back(font->getCharSize('\n').h);
-				if (_lang->getTextWrapping() == WRAP_WORDS)
-				{
-					width = word;
-				}
-				else if (_lang->getTextWrapping() == WRAP_LETTERS)
-				{
-					width = 0;
-				}
-				start = true;
-			}
-		}
-	}
-
+	_run = GlyphRunCache::get(_text, _big, _small, _font, _lang->getTextWrapping(), _wrap, getWidth(), _indent, _ignoreSeparators);
 	_redraw = true;
 }
 
@@ -446,10 +351,10 @@ int Text::getLineX(int line) const
 		case ALIGN_LEFT:
 			break;
 		case ALIGN_CENTER:
-			x = (int)ceil((getWidth() + _font->getSpacing() - _lineWidth[line]) / 2.0);
+			x = (int)ceil((getWidth() + _font->getSpacing() - _run->lineWidth[line]) / 2.0);
 			break;
 		case ALIGN_RIGHT:
-			x = getWidth() - 1 - _lineWidth[line];
+			x = getWidth() - 1 - _run->lineWidth[line];
 			break;
 		}
 		break;
@@ -460,10 +365,10 @@ int Text::getLineX(int line) const
 			x = getWidth() - 1;
 			break;
 		case ALIGN_CENTER:
-			x = getWidth() - (int)ceil((getWidth() + _font->getSpacing() - _lineWidth[line]) / 2.0);
+			x = getWidth() - (int)ceil((getWidth() + _font->getSpacing() - _run->lineWidth[line]) / 2.0);
 			break;
 		case ALIGN_RIGHT:
-			x = _lineWidth[line];
+			x = _run->lineWidth[line];
 			break;
 		}
 		break;
@@ -478,7 +383,7 @@ int Text::getLineX(int line) const
 void Text::draw()
 {
 	Surface::draw();
-	if (_text.empty() || _font == 0)
+	if (_text.empty() || _font == 0 || !_run)
 	{
 		return;
 	}
@@ -499,15 +404,7 @@ void Text::draw()
 		this->drawRect(&r, 0);
 	}
 
-	int x = 0, y = 0, line = 0, height = 0;
-	Font *font = _font;
-	int color = _color;
-	const UString &s = _processedText;
-
-	for (std::vector<int>::iterator i = _lineHeight.begin(); i != _lineHeight.end(); ++i)
-	{
-		height += *i;
-	}
+	int y = 0, height = getTextHeight();
 
 	switch (_valign)
 	{
@@ -522,8 +419,6 @@ void Text::draw()
 		break;
 	}
 
-	x = getLineX(line);
-
 	// Set up text color
 	int mul = 1;
 	if (_contrast)
@@ -532,47 +427,26 @@ void Text::draw()
 	}
 
 	// Set up text direction
-	int dir = 1;
-	if (_lang->getTextDirection() == DIRECTION_RTL)
-	{
-		dir = -1;
-	}
+	bool rtl = _lang->getTextDirection() == DIRECTION_RTL;
 
 	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
 	int mid = _invert ? 3 : 0;
 
-	// Draw each letter one by one
-	for (UString::const_iterator c = s.begin(); c != s.end(); ++c)
+	// Line positions only depend on the alignment
+	std::vector<int> lineX(_run->lineWidth.size());
+	for (size_t line = 0; line < lineX.size(); ++line)
 	{
-		if (Unicode::isSpace(*c) || *c == '\t')
-		{
-			x += dir * font->getCharSize(*c).w;
-		}
-		else if (Unicode::isLinebreak(*c))
-		{
-			line++;
-			y += font->getCharSize(*c).h;
-			x = getLineX(line);
-			if (*c == Unicode::TOK_NL_SMALL)
-			{
-				font = _small;
-			}
-		}
-		else if (*c == Unicode::TOK_COLOR_FLIP)
-		{
-			color = (color == _color ? _color2 : _color);
-		}
-		else
-		{
-			if (dir < 0)
-				x += dir * font->getCharSize(*c).w;
-			auto chr = font->getChar(*c);
-			chr.setX(x);
-			chr.setY(y);
-			ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
-			if (dir > 0)
-				x += dir * font->getCharSize(*c).w;
-		}
+		lineX[line] = getLineX(line);
+	}
+
+	// Draw each letter already placed by the glyph run
+	for (std::vector<Glyph>::const_iterator i = _run->glyphs.begin(); i != _run->glyphs.end(); ++i)
+	{
+		SurfaceCrop chr = i->chr;
+		chr.setX(rtl ? lineX[i->line] - i->offset - i->width : lineX[i->line] + i->offset);
+		chr.setY(y + i->y);
+		int color = i->flip ? _color2 : _color;
+		ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
 	}
 }
 
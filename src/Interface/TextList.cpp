@@ -40,7 +40,7 @@ namespace OpenXcom
  * @param y Y position in pixels.
  */
 TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y),
-	_big(0), _small(0), _font(0), _lang(nullptr), _scroll(0), _visibleRows(0), _selRow(0), _color(0), _color2(0),
+	_drawnBegin(0), _drawnEnd(0), _big(0), _small(0), _font(0), _lang(nullptr), _scroll(0), _visibleRows(0), _selRow(0), _color(0), _color2(0),
 	_dot(false), _selectable(false), _condensed(false), _contrast(false), _wrap(false), _flooding(false), _ignoreSeparators(false),
 	_bg(0), _selector(0), _margin(0), _scrolling(true), _arrowPos(-1), _scrollPos(4), _arrowType(ARROW_VERTICAL),
 	_leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0),
@@ -63,13 +63,21 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<TextListRow>::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
+		for (std::vector<TextListCell>::iterator v = u->cells.begin(); v < u->cells.end(); ++v)
 		{
-			delete *v;
+			delete v->surface;
 		}
 	}
+	for (std::vector<Text*>::iterator i = _textPool.begin(); i < _textPool.end(); ++i)
+	{
+		delete *i;
+	}
+	for (std::vector<Text*>::iterator i = _layoutTexts.begin(); i < _layoutTexts.end(); ++i)
+	{
+		delete *i;
+	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
 		delete *i;
@@ -155,7 +163,12 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	TextListCell &cell = _texts[row].cells[column];
+	cell.color = color;
+	if (cell.surface)
+	{
+		cell.surface->setColor(color);
+	}
 	_redraw = true;
 }
 
@@ -166,9 +179,13 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (std::vector<TextListCell>::iterator i = _texts[row].cells.begin(); i < _texts[row].cells.end(); ++i)
 	{
-		(*i)->setColor(color);
+		i->color = color;
+		if (i->surface)
+		{
+			i->surface->setColor(color);
+		}
 	}
 	_redraw = true;
 }
@@ -181,7 +198,7 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::string TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	return _texts[row].cells[column].text;
 }
 
 /**
@@ -192,7 +209,25 @@ std::string TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::string &text)
 {
-	_texts[row][column]->setText(text);
+	TextListRow &r = _texts[row];
+	TextListCell &cell = r.cells[column];
+
+	// measure the new text the same way the drawn text would take it
+	Text *layout = getLayoutText(cell.width, r.height);
+	setupText(layout, r, cell);
+	layout->setText(text);
+	cell.text = layout->getText();
+	cell.big = layout->getFont() == _big;
+	if (column == 0)
+	{
+		r.textHeight = layout->getTextHeight();
+		r.numLines = layout->getNumLines();
+	}
+
+	if (cell.surface)
+	{
+		setupText(cell.surface, r, cell);
+	}
 	_redraw = true;
 }
 
@@ -203,7 +238,7 @@ void TextList::setCellText(size_t row, size_t column, const std::string &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _texts[0].cells[column].x;
 }
 
 /**
@@ -213,7 +248,7 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + _texts[row].y;
 }
 
 /**
@@ -223,7 +258,7 @@ int TextList::getRowY(size_t row) const
  */
 int TextList::getTextHeight(size_t row) const
 {
-	return _texts[row].front()->getTextHeight();
+	return _texts[row].textHeight;
 }
 
 /**
@@ -233,7 +268,7 @@ int TextList::getTextHeight(size_t row) const
  */
 int TextList::getNumTextLines(size_t row) const
 {
-	return _texts[row].front()->getNumLines();
+	return _texts[row].numLines;
 }
 
 /**
@@ -292,13 +327,16 @@ void TextList::addRow(int cols, ...)
 		ncols = 1;
 	}
 
-	std::vector<Text*> temp;
+	TextListRow temp;
 	// Positions are relative to list surface.
 	int rowX = 0, rowY = 0, rows = 1, rowHeight = 0;
 	if (!_texts.empty())
 	{
-		rowY = _texts.back().front()->getY() + _texts.back().front()->getHeight() + _font->getSpacing();
+		rowY = _texts.back().y + _texts.back().height + _font->getSpacing();
 	}
+	temp.y = rowY;
+	temp.color2 = _color2;
+	temp.ignoreSeparators = _ignoreSeparators;
 
 	for (int i = 0; i < ncols; ++i)
 	{
@@ -312,16 +350,11 @@ void TextList::addRow(int cols, ...)
 		{
 			width = _columns[i];
 		}
-		Text* txt = new Text(width, _font->getHeight(), _margin + rowX, rowY);
-		txt->setPalette(this->getPalette());
+		// only measure the text here, it gets its own surface when scrolled into view
+		Text* txt = getLayoutText(width, _font->getHeight());
 		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
-		{
-			txt->setAlign(_align[i]);
-		}
-		txt->setHighContrast(_contrast);
+		txt->setWordWrap(false);
+		txt->setAlign(_align[i] ? _align[i] : ALIGN_LEFT);
 		if (_font == _big)
 		{
 			txt->setBig();
@@ -330,14 +363,15 @@ void TextList::addRow(int cols, ...)
 		{
 			txt->setSmall();
 		}
-		if (cols > 0)
-			txt->setText(va_arg(args, char*));
+		txt->setText(cols > 0 ? va_arg(args, char*) : "");
 		// grab this before we enable word wrapping so we can use it to calculate
 		// the total row height below
 		int vmargin = _font->getHeight() - txt->getTextHeight();
 		// Wordwrap text if necessary
+		bool wrap = false;
 		if (_wrap && txt->getTextWidth() > txt->getWidth())
 		{
+			wrap = true;
 			txt->setWordWrap(true, true, _ignoreSeparators);
 			rows = std::max(rows, txt->getNumLines());
 		}
@@ -364,7 +398,21 @@ void TextList::addRow(int cols, ...)
 			txt->setText(buf);
 		}
 
-		temp.push_back(txt);
+		TextListCell cell;
+		cell.text = txt->getText();
+		cell.x = _margin + rowX;
+		cell.width = width;
+		cell.color = _color;
+		cell.align = _align[i];
+		cell.big = txt->getFont() == _big;
+		cell.wrap = wrap;
+		cell.surface = 0;
+		temp.cells.push_back(cell);
+		if (i == 0)
+		{
+			temp.textHeight = txt->getTextHeight();
+			temp.numLines = txt->getNumLines();
+		}
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -376,10 +424,7 @@ void TextList::addRow(int cols, ...)
 	}
 
 	// ensure all elements in this row are the same height
-	for (int i = 0; i < cols; ++i)
-	{
-		temp[i]->setHeight(rowHeight);
-	}
+	temp.height = rowHeight;
 
 	_texts.push_back(temp);
 	for (int i = 0; i < rows; ++i)
@@ -432,7 +477,9 @@ void TextList::removeLastRow()
 {
 	if (!_texts.empty())
 	{
+		hideRow(_texts.size() - 1);
 		_texts.pop_back();
+		_drawnEnd = std::min(_drawnEnd, _texts.size());
 	}
 	if (!_rows.empty())
 	{
@@ -488,11 +535,14 @@ void TextList::setColumns(int cols, ...)
 void TextList::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (size_t i = _drawnBegin; i < _drawnEnd; ++i)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<TextListCell>::iterator v = _texts[i].cells.begin(); v < _texts[i].cells.end(); ++v)
 		{
-			(*v)->setPalette(colors, firstcolor, ncolors);
+			if (v->surface)
+			{
+				v->surface->setPalette(colors, firstcolor, ncolors);
+			}
 		}
 	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
@@ -559,11 +609,15 @@ void TextList::setColor(Uint8 color)
 	_up->setColor(color);
 	_down->setColor(color);
 	_scrollbar->setColor(color);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector<TextListRow>::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<TextListCell>::iterator v = u->cells.begin(); v < u->cells.end(); ++v)
 		{
-			(*v)->setColor(color);
+			v->color = color;
+			if (v->surface)
+			{
+				v->surface->setColor(color);
+			}
 		}
 	}
 }
@@ -614,11 +668,14 @@ void TextList::setWordWrap(bool wrap)
 void TextList::setHighContrast(bool contrast)
 {
 	_contrast = contrast;
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (size_t i = _drawnBegin; i < _drawnEnd; ++i)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<TextListCell>::iterator v = _texts[i].cells.begin(); v < _texts[i].cells.end(); ++v)
 		{
-			(*v)->setHighContrast(contrast);
+			if (v->surface)
+			{
+				v->surface->setHighContrast(contrast);
+			}
 		}
 	}
 	_scrollbar->setHighContrast(contrast);
@@ -883,15 +940,12 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	scrollUp(true, false);
+	for (size_t i = _drawnBegin; i < _drawnEnd; ++i)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
+		hideRow(i);
 	}
-	scrollUp(true, false);
+	_drawnBegin = _drawnEnd = 0;
 	_texts.clear();
 	_rows.clear();
 	_redraw = true;
@@ -982,6 +1036,109 @@ void TextList::updateVisible()
 	updateArrows();
 }
 
+/**
+ * Gets a text of the given size that is never drawn, used to
+ * lay out cells before any of them get their own surface.
+ * @param width Width of the cell.
+ * @param height Height of the cell.
+ * @return Text for measuring.
+ */
+Text *TextList::getLayoutText(int width, int height)
+{
+	for (std::vector<Text*>::iterator i = _layoutTexts.begin(); i < _layoutTexts.end(); ++i)
+	{
+		if ((*i)->getWidth() == width && (*i)->getHeight() == height)
+		{
+			return *i;
+		}
+	}
+	Text *text = new Text(width, height);
+	_layoutTexts.push_back(text);
+	return text;
+}
+
+/**
+ * Sets up a text to show the contents of a cell,
+ * giving it the same layout as when the row was added.
+ * @param text Text to set up.
+ * @param row Row of the cell.
+ * @param cell Cell to show.
+ */
+void TextList::setupText(Text *text, const TextListRow &row, const TextListCell &cell) const
+{
+	text->setX(cell.x);
+	text->setY(row.y);
+	text->initText(_big, _small, _lang);
+	text->setColor(cell.color);
+	text->setSecondaryColor(row.color2);
+	text->setAlign(cell.align);
+	text->setHighContrast(_contrast);
+	text->setWordWrap(cell.wrap, cell.wrap, cell.wrap && row.ignoreSeparators);
+	// small font first, so the text doesn't get shrunk again
+	text->setText(cell.text);
+	if (cell.big)
+	{
+		text->setBig();
+	}
+}
+
+/**
+ * Gives every cell of a row a text to draw it with,
+ * reusing texts of rows that were scrolled out of view.
+ * @param row Row number.
+ */
+void TextList::showRow(size_t row)
+{
+	TextListRow &r = _texts[row];
+	for (std::vector<TextListCell>::iterator i = r.cells.begin(); i < r.cells.end(); ++i)
+	{
+		if (i->surface)
+		{
+			continue;
+		}
+		for (std::vector<Text*>::iterator j = _textPool.begin(); j < _textPool.end(); ++j)
+		{
+			if ((*j)->getWidth() == i->width && (*j)->getHeight() == r.height)
+			{
+				i->surface = *j;
+				_textPool.erase(j);
+				break;
+			}
+		}
+		if (!i->surface)
+		{
+			i->surface = new Text(i->width, r.height);
+		}
+		i->surface->setPalette(getPalette());
+		setupText(i->surface, r, *i);
+	}
+}
+
+/**
+ * Returns the texts of a row that is no longer visible to the pool.
+ * @param row Row number.
+ */
+void TextList::hideRow(size_t row)
+{
+	TextListRow &r = _texts[row];
+	for (std::vector<TextListCell>::iterator i = r.cells.begin(); i < r.cells.end(); ++i)
+	{
+		if (!i->surface)
+		{
+			continue;
+		}
+		if (_textPool.size() < TEXT_POOL_SIZE)
+		{
+			_textPool.push_back(i->surface);
+		}
+		else
+		{
+			delete i->surface;
+		}
+		i->surface = 0;
+	}
+}
+
 /**
  * Changes whether the list can be scrolled.
  * @param scrolling True to allow scrolling, false otherwise.
@@ -1006,6 +1163,7 @@ void TextList::draw()
 {
 	Surface::draw();
 	int y = 0;
+	size_t begin = 0, end = 0;
 	if (!_rows.empty())
 	{
 		// for wrapped items, offset the draw height above the visible surface
@@ -1014,23 +1172,30 @@ void TextList::draw()
 		{
 			y -= _font->getHeight() + _font->getSpacing();
 		}
-		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+		begin = _rows[_scroll];
+		end = std::min(_texts.size(), _rows[_scroll] + _visibleRows);
+		for (size_t i = begin; i < end; ++i)
 		{
-			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
-			{
-				(*j)->setY(y);
-				(*j)->blit(this->getSurface());
-			}
-			if (!_texts[i].empty())
+			_texts[i].y = y;
+			showRow(i);
+			for (std::vector<TextListCell>::iterator j = _texts[i].cells.begin(); j < _texts[i].cells.end(); ++j)
 			{
-				y += _texts[i].front()->getHeight() + _font->getSpacing();
-			}
-			else
-			{
-				y += _font->getHeight() + _font->getSpacing();
+				j->surface->setY(y);
+				j->surface->blit(this->getSurface());
 			}
+			y += _texts[i].height + _font->getSpacing();
 		}
 	}
+	// rows scrolled out of view give their texts back
+	for (size_t i = _drawnBegin; i < _drawnEnd; ++i)
+	{
+		if (i < begin || i >= end)
+		{
+			hideRow(i);
+		}
+	}
+	_drawnBegin = begin;
+	_drawnEnd = end;
 }
 
 /**
@@ -1066,14 +1231,7 @@ void TextList::blit(SDL_Surface *surface)
 					_arrowRight[i]->blit(surface);
 				}
 
-				if (!_texts[i].empty())
-				{
-					y += _texts[i].front()->getHeight() + _font->getSpacing();
-				}
-				else
-				{
-					y += _font->getHeight() + _font->getSpacing();
-				}
+				y += _texts[i].height + _font->getSpacing();
 			}
 		}
 		_up->blit(surface);
@@ -1229,9 +1387,9 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (rowHeight * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
-			int y = getY() + selText->getY();
-			int actualHeight = selText->getHeight() + _font->getSpacing(); //current line height
+			const TextListRow &selText = _texts[_rows[_selRow]];
+			int y = getY() + selText.y;
+			int actualHeight = selText.height + _font->getSpacing(); //current line height
 			if (y < getY() || y + actualHeight > getY() + getHeight())
 			{
 				actualHeight /= 2;
@@ -40,7 +40,30 @@ class ScrollBar;
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	/// Contents of one cell, drawn by a Text only while its row is visible.
+	struct TextListCell
+	{
+		std::string text;
+		int x, width;
+		Uint8 color;
+		TextHAlign align;
+		bool big, wrap;
+		Text *surface;
+	};
+	/// Cells of one row and their layout, calculated when the row is added.
+	struct TextListRow
+	{
+		std::vector<TextListCell> cells;
+		int y, height, textHeight, numLines;
+		Uint8 color2;
+		bool ignoreSeparators;
+	};
+	/// Maximum number of unused Texts kept for reuse.
+	static const size_t TEXT_POOL_SIZE = 64;
+
+	std::vector<TextListRow> _texts;
+	std::vector<Text*> _textPool, _layoutTexts;
+	size_t _drawnBegin, _drawnEnd;
 	std::vector<size_t> _columns, _rows;
 	Font *_big, *_small, *_font;
 	Language *_lang;
@@ -65,6 +88,14 @@ private:
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Gets a text used to measure cells without drawing them.
+	Text *getLayoutText(int width, int height);
+	/// Sets up a text to show a cell.
+	void setupText(Text *text, const TextListRow &row, const TextListCell &cell) const;
+	/// Creates the texts for a row scrolled into view.
+	void showRow(size_t row);
+	/// Returns the texts of a row scrolled out of view to the pool.
+	void hideRow(size_t row);
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
@@ -23,6 +23,8 @@
 #include <climits>
 #include <unordered_map>
 #include <cassert>
+#include <chrono>
+#include <memory>
 #include "../Engine/CrossPlatform.h"
 #include "../Engine/FileMap.h"
 #include "../Engine/SDL2Helpers.h"
@@ -34,6 +36,7 @@
 #include "../Engine/GMCat.h"
 #include "../Engine/SoundSet.h"
 #include "../Engine/Sound.h"
+#include "../Interface/GlyphRun.h"
 #include "../Interface/TextButton.h"
 #include "../Interface/Window.h"
 #include "MapDataSet.h"
@@ -44,6 +47,8 @@
 #include "../Engine/Logger.h"
 #include "../Engine/ScriptBind.h"
 #include "../Engine/Collections.h"
+#include "../Engine/WorkerPool.h"
+#include "RulesetCache.h"
 #include "SoundDefinition.h"
 #include "ExtraSprites.h"
 #include "CustomPalettes.h"
@@ -504,6 +509,7 @@ Mod::~Mod()
 	{
 		delete i->second;
 	}
+	GlyphRunCache::clear();
 	for (std::map<std::string, Surface*>::iterator i = _surfaces.begin(); i != _surfaces.end(); ++i)
 	{
 		delete i->second;
@@ -1609,6 +1615,21 @@ static void throwModOnErrorHelper(const std::string& modId, const std::string& e
 	throw Exception(errorStream.str());
 }
 
+namespace
+{
+
+/**
+ * Gets the milliseconds passed since a point in time.
+ * @param start Starting point.
+ * @return Elapsed milliseconds.
+ */
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 /**
  * Loads a list of mods specified in the options.
  * List of <modId, rulesetFiles> pairs is fetched from the FileMap / VFS
@@ -1678,6 +1699,7 @@ void Mod::loadAll()
 	_soundOffsetGeo = _sounds["GEO.CAT"]->getMaxSharedSounds();
 
 	Log(LOG_INFO) << "Loading rulesets...";
+	auto rulesetsStart = std::chrono::steady_clock::now();
 	// load rest rulesets
 	for (size_t i = 0; mods.size() > i; ++i)
 	{
@@ -1685,6 +1707,7 @@ void Mod::loadAll()
 		{
 			_modCurrent = &_modData.at(i);
 			_scriptGlobal->setMod((int)_modCurrent->offset);
+			_scriptGlobal->setLoadingModName(mods[i].first);
 			loadMod(mods[i].second, parser);
 		}
 		catch (Exception &e)
@@ -1693,10 +1716,11 @@ void Mod::loadAll()
 			throwModOnErrorHelper(modId, e.what());
 		}
 	}
-	Log(LOG_INFO) << "Loading rulesets done.";
+	Log(LOG_INFO) << "Loading rulesets done in " << millisecondsSince(rulesetsStart) << " ms.";
 
 	//back master
 	_modCurrent = &_modData.at(0);
+	_scriptGlobal->setLoadingModName(mods.at(0).first);
 	_scriptGlobal->endLoad();
 
 	// post-processing item categories
@@ -1751,6 +1775,7 @@ void Mod::loadAll()
 	afterLoadHelper("skills", this, _skills, &RuleSkill::afterLoad);
 	afterLoadHelper("craftWeapons", this, _craftWeapons, &RuleCraftWeapon::afterLoad);
 	afterLoadHelper("countries", this, _countries, &RuleCountry::afterLoad);
+	_globe->afterLoad(this);
 
 	for (auto& a : _armors)
 	{
@@ -1876,23 +1901,84 @@ void Mod::loadAll()
 /**
  * Loads a list of rulesets from YAML files for the mod at the specified index. The first
  * mod loaded should be the master at index 0, then 1, and so on.
+ * All files of the mod are parsed in parallel first, then applied one by one
+ * in their original order, so later files still override earlier ones.
  * @param rulesetFiles List of rulesets to load.
  * @param parsers Object with all available parsers.
  */
 void Mod::loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers)
 {
-	for (auto i = rulesetFiles.begin(); i != rulesetFiles.end(); ++i)
+	auto parseStart = std::chrono::steady_clock::now();
+
+	std::vector<YAML::Node> docs(rulesetFiles.size());
+	const bool useCache = Options::oxceRulesetCache;
+	const Uint64 cacheKey = useCache ? RulesetCache::getKey(rulesetFiles) : 0;
+	const bool cached = useCache && RulesetCache::load(_modCurrent->name, cacheKey, docs);
+	if (!cached)
+	{
+		// file access (zip archives especially) is not thread safe, only yaml-cpp runs in parallel
+		std::vector<std::unique_ptr<std::istream> > streams;
+		std::vector<std::string> errors(rulesetFiles.size());
+		for (auto i = rulesetFiles.begin(); i != rulesetFiles.end(); ++i)
+		{
+			streams.push_back(i->getIStream());
+		}
+		auto parse = [&](int i)
+		{
+			try
+			{
+				docs[i] = YAML::Load(*streams[i]);
+			}
+			catch (std::exception &e)
+			{
+				errors[i] = e.what();
+			}
+			streams[i].reset();
+		};
+		WorkerPool::run((int)docs.size(), parse);
+
+		for (size_t i = 0; i < rulesetFiles.size(); ++i)
+		{
+			if (!errors[i].empty())
+			{
+				Log(LOG_FATAL) << "Error loading file '" << rulesetFiles[i].fullpath << "'";
+				throw Exception(rulesetFiles[i].fullpath + ": " + errors[i]);
+			}
+		}
+	}
+
+	double parseTime = millisecondsSince(parseStart);
+	auto applyStart = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < rulesetFiles.size(); ++i)
 	{
-		Log(LOG_VERBOSE) << "- " << i->fullpath;
+		Log(LOG_VERBOSE) << "- " << rulesetFiles[i].fullpath;
 		try
 		{
-			loadFile(*i, parsers);
+			loadFile(docs[i], parsers);
 		}
 		catch (YAML::Exception &e)
 		{
-			throw Exception(i->fullpath + ": " + std::string(e.what()));
+			if (cached)
+			{
+				RulesetCache::remove(_modCurrent->name);
+			}
+			throw Exception(rulesetFiles[i].fullpath + ": " + std::string(e.what()));
+		}
+		catch (...)
+		{
+			// cached files have no line numbers, parse them again next time to report the error properly
+			if (cached)
+			{
+				RulesetCache::remove(_modCurrent->name);
+			}
+			throw;
 		}
 	}
+	if (useCache && !cached)
+	{
+		RulesetCache::save(_modCurrent->name, cacheKey, docs);
+	}
 
 	// these need to be validated, otherwise we're gonna get into some serious trouble down the line.
 	// it may seem like a somewhat arbitrary limitation, but there is a good reason behind it.
@@ -1950,6 +2036,8 @@ void Mod::loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScrip
 			}
 		}
 	}
+
+	Log(LOG_INFO) << "- " << _modCurrent->name << ": " << rulesetFiles.size() << " files " << (cached ? "read from cache" : "parsed") << " in " << parseTime << " ms, applied in " << millisecondsSince(applyStart) << " ms";
 }
 
 /**
@@ -2042,15 +2130,13 @@ void Mod::loadConstants(const YAML::Node &node)
 }
 
 /**
- * Loads a ruleset's contents from a YAML file.
+ * Loads a ruleset's contents from a parsed YAML file.
  * Rules that match pre-existing rules overwrite them.
- * @param filename YAML filename.
+ * @param doc YAML document of the file.
  * @param parsers Object with all available parsers.
  */
-void Mod::loadFile(const FileMap::FileRecord &filerec, ModScript &parsers)
+void Mod::loadFile(YAML::Node doc, ModScript &parsers)
 {
-	auto doc = filerec.getYAML();
-
 	if (const YAML::Node &extended = doc["extended"])
 	{
 		_scriptGlobal->load(extended);
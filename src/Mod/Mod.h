@@ -300,8 +300,8 @@ private:
 	/// Loads a ruleset from a YAML file that have basic resources configuration.
 	void loadResourceConfigFile(const FileMap::FileRecord &filerec);
 	void loadConstants(const YAML::Node &node);
-	/// Loads a ruleset from a YAML file.
-	void loadFile(const FileMap::FileRecord &filerec, ModScript &parsers);
+	/// Loads a ruleset from a parsed YAML file.
+	void loadFile(YAML::Node doc, ModScript &parsers);
 	/// Loads a ruleset element.
 	template <typename T>
 	T *loadRule(const YAML::Node &node, std::map<std::string, T*> *map, std::vector<std::string> *index = 0, const std::string &key = "type") const;
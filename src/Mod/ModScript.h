@@ -73,6 +73,7 @@ class StatsForNerdsState;
 class ModScript
 {
 	friend class Mod;
+	friend class ScriptBenchmark;
 
 	ScriptGlobal* _shared;
 	Mod* _mod;
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleGlobe.h"
+#include <algorithm>
+#include <cmath>
 #include <SDL_endian.h>
 #include "../Engine/Exception.h"
 #include "Polygon.h"
@@ -148,6 +150,165 @@ std::list<Polygon*> *RuleGlobe::getPolygons()
 	return &_polygons;
 }
 
+/**
+ * Precomputes everything needed to find the polygon under a point:
+ * sines and cosines of all polygon points, a spherical cap around
+ * every polygon and a lon/lat grid listing polygons overlapping each cell.
+ * @param mod Mod for cross link.
+ */
+void RuleGlobe::afterLoad(const Mod* mod)
+{
+	const double cellLon = 2 * M_PI / GRID_LON;
+	const double cellLat = M_PI / GRID_LAT;
+	const double margin = 1e-6;
+
+	_polygonPoints.clear();
+	_polygonBounds.clear();
+	_polygonGrid.assign(GRID_LON * GRID_LAT, std::vector<int>());
+
+	for (std::list<Polygon*>::iterator i = _polygons.begin(); i != _polygons.end(); ++i)
+	{
+		PolygonBounds bounds;
+		bounds.polygon = *i;
+		bounds.firstPoint = (int)_polygonPoints.size();
+		bounds.points = (*i)->getPoints();
+
+		double x = 0, y = 0, z = 0;
+		for (int j = 0; j < bounds.points; ++j)
+		{
+			const double lon = (*i)->getLongitude(j);
+			const double lat = (*i)->getLatitude(j);
+			PolygonPoint point = { lon, sin(lat), cos(lat) };
+			_polygonPoints.push_back(point);
+			x += point.cosLat * cos(lon);
+			y += point.cosLat * sin(lon);
+			z += point.sinLat;
+		}
+
+		// cap centered in the middle of the points, reaching the farthest one
+		const double norm = sqrt(x * x + y * y + z * z);
+		double minDot = -1.0;
+		if (norm > margin)
+		{
+			x /= norm;
+			y /= norm;
+			z /= norm;
+			minDot = 1.0;
+			for (int j = 0; j < bounds.points; ++j)
+			{
+				const PolygonPoint &point = _polygonPoints[bounds.firstPoint + j];
+				minDot = std::min(minDot, x * point.cosLat * cos(point.lon) + y * point.cosLat * sin(point.lon) + z * point.sinLat);
+			}
+		}
+		bounds.capX = x;
+		bounds.capY = y;
+		bounds.capZ = z;
+		bounds.capMinDot = minDot - margin;
+
+		const int index = (int)_polygonBounds.size();
+		_polygonBounds.push_back(bounds);
+
+		// cells touched by the cap
+		const double radius = acos(Clamp(minDot, -1.0, 1.0)) + margin;
+		const double centerLat = asin(Clamp(z, -1.0, 1.0));
+		const double centerLon = atan2(y, x);
+		const int latBegin = Clamp((int)floor((centerLat - radius + M_PI / 2) / cellLat), 0, GRID_LAT - 1);
+		const int latEnd = Clamp((int)floor((centerLat + radius + M_PI / 2) / cellLat), 0, GRID_LAT - 1);
+		int lonBegin = 0;
+		int lonEnd = GRID_LON - 1;
+		if (norm > margin && centerLat + radius < M_PI / 2 && centerLat - radius > -M_PI / 2)
+		{
+			const double halfLon = asin(std::min(1.0, sin(radius) / cos(centerLat))) + margin;
+			lonBegin = (int)floor((centerLon - halfLon) / cellLon);
+			lonEnd = std::min((int)floor((centerLon + halfLon) / cellLon), lonBegin + GRID_LON - 1);
+		}
+		for (int lat = latBegin; lat <= latEnd; ++lat)
+		{
+			for (int lon = lonBegin; lon <= lonEnd; ++lon)
+			{
+				_polygonGrid[lat * GRID_LON + ((lon % GRID_LON) + GRID_LON) % GRID_LON].push_back(index);
+			}
+		}
+	}
+}
+
+/**
+ * Gets the cell of the lookup grid containing a point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Index of the cell.
+ */
+int RuleGlobe::getGridCell(double lon, double lat)
+{
+	lon = fmod(lon, 2 * M_PI);
+	if (lon < 0)
+	{
+		lon += 2 * M_PI;
+	}
+	const int x = Clamp((int)floor(lon / (2 * M_PI / GRID_LON)), 0, GRID_LON - 1);
+	const int y = Clamp((int)floor((lat + M_PI / 2) / (M_PI / GRID_LAT)), 0, GRID_LAT - 1);
+	return y * GRID_LON + x;
+}
+
+/**
+ * Gets the first polygon, in ruleset order, containing a point.
+ * Only polygons listed in the grid cell of the point are checked.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the polygon, or null if the point is not on land.
+ */
+Polygon *RuleGlobe::getPolygonFromLonLat(double lon, double lat) const
+{
+	if (_polygonGrid.empty())
+	{
+		return 0;
+	}
+
+	const double zDiscard=0.75f;
+	double coslat = cos(lat);
+	double sinlat = sin(lat);
+	const double px = coslat * cos(lon);
+	const double py = coslat * sin(lon);
+
+	for (int index : _polygonGrid[getGridCell(lon, lat)])
+	{
+		const PolygonBounds &bounds = _polygonBounds[index];
+		if (px * bounds.capX + py * bounds.capY + sinlat * bounds.capZ < bounds.capMinDot)
+		{
+			continue;
+		}
+		const PolygonPoint *points = &_polygonPoints[bounds.firstPoint];
+
+		double x, y, z, x2, y2;
+		z = 0;
+		for (int j = 0; j < bounds.points; ++j)
+		{
+			z = coslat * points[j].cosLat * cos(points[j].lon - lon) + sinlat * points[j].sinLat;
+			if (z<zDiscard) break; //discarded
+		}
+		if (z<zDiscard) continue; //discarded
+
+		bool odd = false;
+
+		x = points[0].cosLat * sin(points[0].lon - lon); //initial point
+		y = coslat * points[0].sinLat - sinlat * points[0].cosLat * cos(points[0].lon - lon);
+
+		for (int j = 0; j < bounds.points; ++j)
+		{
+			int k = (j + 1) % bounds.points; //index of next point in poly
+
+			x2 = points[k].cosLat * sin(points[k].lon - lon);
+			y2 = coslat * points[k].sinLat - sinlat * points[k].cosLat * cos(points[k].lon - lon);
+			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
+				odd = !odd;
+			x = x2;
+			y = y2;
+		}
+		if (odd) return bounds.polygon;
+	}
+	return 0;
+}
+
 /**
  * Returns the list of polylines in the globe.
  * @return Pointer to the list of polylines.
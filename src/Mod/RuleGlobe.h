@@ -19,11 +19,13 @@
  */
 #include <list>
 #include <string>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
 
+class Mod;
 class Polygon;
 class Polyline;
 class Texture;
@@ -36,9 +38,31 @@ class Texture;
 class RuleGlobe
 {
 private:
+	/// Point of a polygon with cached trigonometry.
+	struct PolygonPoint
+	{
+		double lon, sinLat, cosLat;
+	};
+	/// Polygon with the smallest spherical cap around it.
+	struct PolygonBounds
+	{
+		Polygon *polygon;
+		int firstPoint, points;
+		double capX, capY, capZ, capMinDot;
+	};
+	static const int GRID_LON = 180;
+	static const int GRID_LAT = 90;
+
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+	std::vector<PolygonPoint> _polygonPoints;
+	std::vector<PolygonBounds> _polygonBounds;
+	/// Indexes of polygons that can contain points of each lon/lat cell, in polygon list order.
+	std::vector<std::vector<int> > _polygonGrid;
+
+	/// Gets the grid cell of a point.
+	static int getGridCell(double lon, double lat);
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -46,8 +70,12 @@ public:
 	~RuleGlobe();
 	/// Loads the globe from YAML.
 	void load(const YAML::Node& node);
+	/// Builds the polygon lookup index.
+	void afterLoad(const Mod* mod);
 	/// Gets the list of world polygons.
 	std::list<Polygon*> *getPolygons();
+	/// Gets the polygon containing a point.
+	Polygon *getPolygonFromLonLat(double lon, double lat) const;
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
 	/// Loads a set of polygons from a DAT file.
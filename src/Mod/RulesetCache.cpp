@@ -0,0 +1,236 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "RulesetCache.h"
+#include "../Engine/BinaryNode.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/SDL2Helpers.h"
+#include "../Engine/Options.h"
+#include "../Engine/Logger.h"
+#include "../Engine/WorkerPool.h"
+#include "../version.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char CacheMagic[4] = { 'O', 'X', 'R', 'C' };
+const Uint32 CacheVersion = 1;
+
+/**
+ * Gets the path of the cache file of a mod.
+ * @param modId Mod ID.
+ * @return Full path.
+ */
+std::string getCachePath(const std::string &modId)
+{
+	return Options::getUserFolder() + "cache/" + modId + ".rulcache";
+}
+
+/**
+ * Mixes bytes into a 64-bit FNV-1a hash.
+ * @param hash Hash to update.
+ * @param data Bytes to add.
+ * @param size Number of bytes.
+ */
+void hashBytes(Uint64 &hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+}
+
+/**
+ * Mixes a string, including its terminator, into a hash.
+ * @param hash Hash to update.
+ * @param s String to add.
+ */
+void hashString(Uint64 &hash, const std::string &s)
+{
+	hashBytes(hash, s.c_str(), s.size() + 1);
+}
+
+/**
+ * Mixes a number into a hash, independent of the byte order.
+ * @param hash Hash to update.
+ * @param value Number to add.
+ */
+void hashNumber(Uint64 &hash, Uint64 value)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		unsigned char byte = (unsigned char)(value >> (i * 8));
+		hashBytes(hash, &byte, 1);
+	}
+}
+
+}
+
+/**
+ * Calculates the key of a list of ruleset files, which changes whenever
+ * a file is added, removed, renamed, resized or modified, or the engine
+ * version changes.
+ * @param rulesetFiles List of rulesets of a mod.
+ * @return Key of the files.
+ */
+Uint64 RulesetCache::getKey(const std::vector<FileMap::FileRecord> &rulesetFiles)
+{
+	Uint64 hash = 0xCBF29CE484222325ULL;
+	hashString(hash, OPENXCOM_VERSION_SHORT OPENXCOM_VERSION_GIT);
+	hashNumber(hash, CacheVersion);
+	for (std::vector<FileMap::FileRecord>::const_iterator i = rulesetFiles.begin(); i != rulesetFiles.end(); ++i)
+	{
+		Uint64 size, stamp;
+		i->getStat(size, stamp);
+		hashString(hash, i->fullpath);
+		hashNumber(hash, size);
+		hashNumber(hash, stamp);
+	}
+	return hash;
+}
+
+/**
+ * Loads the parsed ruleset files of a mod. The files are decoded
+ * in parallel on the worker pool.
+ * @param modId Mod ID.
+ * @param key Key of the current ruleset files.
+ * @param docs Gets one document per ruleset file, in the original order.
+ * @return True if the cache existed, matched and was read in full.
+ */
+bool RulesetCache::load(const std::string &modId, Uint64 key, std::vector<YAML::Node> &docs)
+{
+	SDL_RWops *rwops = SDL_RWFromFile(getCachePath(modId).c_str(), "rb");
+	if (!rwops)
+	{
+		return false;
+	}
+	size_t size = 0;
+	unsigned char *data = (unsigned char *)SDL_LoadFile_RW(rwops, &size, SDL_TRUE);
+	if (!data)
+	{
+		return false;
+	}
+
+	bool ok = size >= sizeof(CacheMagic) && std::equal(CacheMagic, CacheMagic + sizeof(CacheMagic), (const char *)data);
+	BinaryNodeReader header(data + sizeof(CacheMagic), data + size);
+	if (ok)
+	{
+		ok = header.readFixed(4) == CacheVersion && header.readFixed(8) == key && header.readFixed(4) == docs.size() && header.ok();
+	}
+	std::vector<std::pair<const unsigned char *, const unsigned char *> > ranges;
+	if (ok)
+	{
+		// the header lists the size of every document, so they can be read independently
+		std::vector<Uint64> sizes;
+		Uint64 total = 0;
+		for (size_t i = 0; i < docs.size(); ++i)
+		{
+			sizes.push_back(header.readFixed(4));
+			total += sizes.back();
+		}
+		const unsigned char *start = header.getPosition();
+		ok = header.ok() && total == (Uint64)(data + size - start);
+		for (size_t i = 0; ok && i < docs.size(); ++i)
+		{
+			ranges.push_back(std::make_pair(start, start + sizes[i]));
+			start += sizes[i];
+		}
+	}
+	if (ok)
+	{
+		std::vector<char> valid(docs.size(), 0);
+		auto decode = [&](int i)
+		{
+			BinaryNodeReader reader(ranges[i].first, ranges[i].second);
+			docs[i] = reader.readNode(0);
+			valid[i] = reader.ok() && reader.atEnd();
+		};
+		WorkerPool::run((int)docs.size(), decode);
+		ok = std::find(valid.begin(), valid.end(), 0) == valid.end();
+	}
+	SDL_free(data);
+
+	if (!ok)
+	{
+		Log(LOG_INFO) << "Ruleset cache of " << modId << " is outdated.";
+		for (std::vector<YAML::Node>::iterator i = docs.begin(); i != docs.end(); ++i)
+		{
+			*i = YAML::Node();
+		}
+	}
+	return ok;
+}
+
+/**
+ * Saves the parsed ruleset files of a mod, replacing its previous cache.
+ * @param modId Mod ID.
+ * @param key Key of the current ruleset files.
+ * @param docs One document per ruleset file, in the original order.
+ */
+void RulesetCache::save(const std::string &modId, Uint64 key, const std::vector<YAML::Node> &docs)
+{
+	std::vector<std::vector<unsigned char> > blobs(docs.size());
+	auto encode = [&](int i)
+	{
+		BinaryNodeWriter writer(blobs[i]);
+		writer.writeNode(docs[i]);
+	};
+	WorkerPool::run((int)docs.size(), encode);
+
+	std::vector<unsigned char> data(CacheMagic, CacheMagic + sizeof(CacheMagic));
+	BinaryNodeWriter writer(data);
+	writer.writeFixed(CacheVersion, 4);
+	writer.writeFixed(key, 8);
+	writer.writeFixed(docs.size(), 4);
+	for (std::vector<std::vector<unsigned char> >::const_iterator i = blobs.begin(); i != blobs.end(); ++i)
+	{
+		writer.writeFixed(i->size(), 4);
+	}
+	for (std::vector<std::vector<unsigned char> >::const_iterator i = blobs.begin(); i != blobs.end(); ++i)
+	{
+		data.insert(data.end(), i->begin(), i->end());
+	}
+
+	std::string folder = Options::getUserFolder() + "cache/";
+	if (!CrossPlatform::folderExists(folder))
+	{
+		CrossPlatform::createFolder(folder);
+	}
+	CrossPlatform::writeFile(getCachePath(modId), data);
+}
+
+/**
+ * Removes the cache of a mod, so it is parsed from the ruleset files next time.
+ * @param modId Mod ID.
+ */
+void RulesetCache::remove(const std::string &modId)
+{
+	std::string path = getCachePath(modId);
+	if (CrossPlatform::fileExists(path))
+	{
+		CrossPlatform::deleteFile(path);
+	}
+}
+
+}
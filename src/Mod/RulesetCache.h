@@ -0,0 +1,49 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <SDL_types.h>
+#include "../Engine/FileMap.h"
+
+namespace OpenXcom
+{
+
+/**
+ * On-disk cache of the parsed ruleset files of each mod, stored as
+ * a compact binary node tree that loads much faster than YAML text.
+ * A cache file is only used while the engine version and the size and
+ * modification stamp of every ruleset file of the mod still match.
+ * Node marks are not stored, so errors in cached files have no line numbers.
+ */
+class RulesetCache
+{
+public:
+	/// Calculates the key of a list of ruleset files.
+	static Uint64 getKey(const std::vector<FileMap::FileRecord> &rulesetFiles);
+	/// Loads the parsed ruleset files of a mod, if the cache matches the key.
+	static bool load(const std::string &modId, Uint64 key, std::vector<YAML::Node> &docs);
+	/// Saves the parsed ruleset files of a mod.
+	static void save(const std::string &modId, Uint64 key, const std::vector<YAML::Node> &docs);
+	/// Removes the cache of a mod.
+	static void remove(const std::string &modId);
+};
+
+}
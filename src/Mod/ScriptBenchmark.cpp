@@ -0,0 +1,303 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScriptBenchmark.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "Mod.h"
+#include "ModScript.h"
+#include "RuleSkill.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Sample hitUnit script, armor and health dependent power bonus.
+const char *const HitUnitSample =
+	"var int armor;\n"
+	"var int threshold;\n"
+	"var int bonus;\n"
+	"set threshold 20;\n"
+	"unit.getArmor armor side;\n"
+	"if le armor threshold;\n"
+	"  set bonus 10;\n"
+	"  add bonus 5;\n"
+	"else;\n"
+	"  set bonus 0;\n"
+	"end;\n"
+	"add power bonus;\n"
+	"unit.getHealth armor;\n"
+	"if eq armor 0;\n"
+	"  mul power 3;\n"
+	"  div power 2;\n"
+	"end;\n"
+	"if le damaging_type 3;\n"
+	"  add power 1;\n"
+	"end;\n"
+	"add power 0;\n"
+	"return power part side;\n";
+
+/// Sample damageUnit script, scales final damage by unit state.
+const char *const DamageUnitSample =
+	"var int stat;\n"
+	"var int scale;\n"
+	"set scale 150;\n"
+	"unit.getHealth stat;\n"
+	"if le stat 0;\n"
+	"  set to_stun 0;\n"
+	"end;\n"
+	"muldiv to_health scale 100;\n"
+	"unit.getHealthMax stat;\n"
+	"add stat 10;\n"
+	"sub stat 10;\n"
+	"if le currPower 50;\n"
+	"  add to_morale 5;\n"
+	"else;\n"
+	"  add to_morale 10;\n"
+	"end;\n"
+	"unit.getFatalwoundsTotal stat;\n"
+	"if le stat 2;\n"
+	"  add to_wound part;\n"
+	"end;\n"
+	"if eq side 0;\n"
+	"  mul to_armor 2;\n"
+	"end;\n"
+	"limit to_armor 0 1000;\n"
+	"return to_health to_armor to_stun to_time to_energy to_morale to_wound to_transform to_mana;\n";
+
+/// Sample visibilityUnit script, smoke and fire lower the visibility.
+const char *const VisibilityUnitSample =
+	"var int smoke;\n"
+	"var int top;\n"
+	"set top 255;\n"
+	"set smoke smoke_density;\n"
+	"mul smoke 2;\n"
+	"if le distance 10;\n"
+	"  add current_visibility 5;\n"
+	"end;\n"
+	"sub current_visibility smoke;\n"
+	"if le fire_density 0;\n"
+	"  add current_visibility 0;\n"
+	"else;\n"
+	"  sub current_visibility fire_density;\n"
+	"end;\n"
+	"target_unit.isKneeled smoke;\n"
+	"if eq smoke 1;\n"
+	"  sub current_visibility 10;\n"
+	"end;\n"
+	"limit current_visibility 0 top;\n"
+	"return current_visibility default_visibility visibility_mode;\n";
+
+/**
+ * Timing of one version of a script.
+ */
+struct BenchmarkResult
+{
+	double seconds = 0.0;
+	Uint64 ops = 0;
+	Uint64 checksum = 0;
+};
+
+/**
+ * Runs a script with pseudo random inputs, first timed, then once more counting executed operations.
+ * @param runs How many times to run the script.
+ * @param call Function running the script once and returning a hash of its outputs.
+ * @return Timings and hash of all the outputs.
+ */
+template<typename Func>
+BenchmarkResult runScript(int runs, Func call)
+{
+	BenchmarkResult result;
+	RNG::RandomState timed(1);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i)
+	{
+		result.checksum = result.checksum * 31 + call(timed, nullptr);
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	RNG::RandomState counted(1);
+	for (int i = 0; i < runs; ++i)
+	{
+		call(counted, &result.ops);
+	}
+	return result;
+}
+
+/**
+ * Prints one result line.
+ * @param report Output stream.
+ * @param name Version of the script.
+ * @param result Timings.
+ * @param runs Number of runs.
+ */
+void printResult(std::ostringstream &report, const char *name, const BenchmarkResult &result, int runs)
+{
+	const double seconds = result.seconds > 0.0 ? result.seconds : 1e-9;
+	report << "  " << std::setw(9) << std::left << name << std::right;
+	report << std::fixed << std::setprecision(0) << std::setw(12) << runs / seconds << " runs/s";
+	report << std::setw(14) << (double)result.ops / runs * (runs / seconds) << " ops/s";
+	report << std::setprecision(1) << std::setw(8) << (double)result.ops / runs << " ops/run" << std::endl;
+}
+
+}
+
+/**
+ * Sets up a script benchmark.
+ * @param runs How many times each script is run.
+ */
+ScriptBenchmark::ScriptBenchmark(int runs) : _runs(runs)
+{
+}
+
+/**
+ *
+ */
+ScriptBenchmark::~ScriptBenchmark()
+{
+}
+
+/**
+ * Parses every sample script twice, without and with the optimizer,
+ * runs both versions and prints the speed of each.
+ * @return Exit code, failure if a script does not parse or the versions give different results.
+ */
+int ScriptBenchmark::run()
+{
+	Log(LOG_INFO) << "Script benchmark: " << _runs << " runs";
+
+	Mod mod;
+	ModScript parsers{ mod.getScriptGlobal(), &mod };
+	auto &unitParsers = parsers.battleUnitScripts;
+
+	ModScript::HitUnit::Container hitUnit[2];
+	ModScript::DamageUnit::Container damageUnit[2];
+	ModScript::VisibilityUnit::Container visibilityUnit[2];
+
+	const bool optimizer = Options::oxceScriptOptimizer;
+	mod.getScriptGlobal()->beginLoad();
+	for (int i = 0; i < 2; ++i)
+	{
+		Options::oxceScriptOptimizer = (i == 1);
+		hitUnit[i].load("benchmark", HitUnitSample, unitParsers.get<ModScript::HitUnit>());
+		damageUnit[i].load("benchmark", DamageUnitSample, unitParsers.get<ModScript::DamageUnit>());
+		visibilityUnit[i].load("benchmark", VisibilityUnitSample, unitParsers.get<ModScript::VisibilityUnit>());
+	}
+	mod.getScriptGlobal()->endLoad();
+	Options::oxceScriptOptimizer = optimizer;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (!hitUnit[i].data() || !damageUnit[i].data() || !visibilityUnit[i].data())
+		{
+			Log(LOG_ERROR) << "Script benchmark: sample scripts failed to parse.";
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::ostringstream report;
+	bool allSame = true;
+	auto compare = [&](const char *name, const BenchmarkResult &plain, const BenchmarkResult &optimized)
+	{
+		const bool same = plain.checksum == optimized.checksum;
+		allSame = allSame && same;
+		report << "Script benchmark: " << name << std::endl;
+		printResult(report, "plain", plain, _runs);
+		printResult(report, "optimized", optimized, _runs);
+		report << "  x" << std::setprecision(2) << (optimized.seconds > 0.0 ? plain.seconds / optimized.seconds : 0.0);
+		if (!same)
+		{
+			report << "  MISMATCH";
+		}
+		report << std::endl;
+	};
+
+	BenchmarkResult results[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		results[i] = runScript(_runs,
+			[&](RNG::RandomState &random, Uint64 *ops)
+			{
+				ModScript::HitUnit::Output args{ random.generate(0, 200), random.generate(0, 5), random.generate(0, 4) };
+				ModScript::HitUnit::Worker work{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, random.generate(0, 200), random.generate(0, 10), random.generate(0, 20) };
+				work.setOpCounter(ops);
+				work.execute(hitUnit[i], args);
+				return (Uint64)(unsigned)args.getFirst() * 7 + (unsigned)args.getSecond() * 3 + (unsigned)args.getThird();
+			}
+		);
+	}
+	compare("hitUnit", results[0], results[1]);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		results[i] = runScript(_runs,
+			[&](RNG::RandomState &random, Uint64 *ops)
+			{
+				ModScript::DamageUnit::Output args{ };
+				std::get<0>(args.data) = random.generate(0, 100);
+				std::get<1>(args.data) = random.generate(0, 20);
+				std::get<2>(args.data) = random.generate(0, 50);
+				ModScript::DamageUnit::Worker work{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, random.generate(0, 100), random.generate(0, 100), random.generate(0, 5), random.generate(0, 4), random.generate(0, 10), random.generate(0, 20) };
+				work.setOpCounter(ops);
+				work.execute(damageUnit[i], args);
+				Uint64 hash = 0;
+				std::apply([&](auto... value) { ((hash = hash * 31 + (unsigned)value), ...); }, args.data);
+				return hash;
+			}
+		);
+	}
+	compare("damageUnit", results[0], results[1]);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		results[i] = runScript(_runs,
+			[&](RNG::RandomState &random, Uint64 *ops)
+			{
+				const int visibility = random.generate(0, 100);
+				ModScript::VisibilityUnit::Output args{ visibility, visibility, ScriptTag<BattleUnitVisibility>::getNullTag() };
+				ModScript::VisibilityUnit::Worker work{ nullptr, nullptr, random.generate(0, 40), random.generate(20, 40), random.generate(0, 15), random.generate(0, 15) };
+				work.setOpCounter(ops);
+				work.execute(visibilityUnit[i], args);
+				return (Uint64)(unsigned)args.getFirst() * 7 + (unsigned)args.getSecond() * 3 + std::get<2>(args.data).get();
+			}
+		);
+	}
+	compare("visibilityUnit", results[0], results[1]);
+
+	std::cout << report.str();
+	Log(LOG_INFO) << report.str();
+	if (!allSame)
+	{
+		Log(LOG_ERROR) << "Script benchmark: optimized scripts give different results.";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+}
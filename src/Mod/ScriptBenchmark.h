@@ -0,0 +1,43 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace OpenXcom
+{
+
+/**
+ * Benchmark of the script engine on unit scripts.
+ * Sample hitUnit, damageUnit and visibilityUnit scripts are parsed
+ * with and without the script optimizer, run with the same inputs,
+ * and the results and timings of both versions are compared.
+ */
+class ScriptBenchmark
+{
+private:
+	int _runs;
+public:
+	/// Creates a script benchmark.
+	ScriptBenchmark(int runs);
+	/// Cleans up the benchmark.
+	~ScriptBenchmark();
+	/// Runs all scripts and prints the timings.
+	int run();
+};
+
+}
@@ -260,6 +260,8 @@ public:
 	void setInterceptionOrder(const int order);
 	/// Gets interception number.
 	int getInterceptionOrder() const;
+	/// Gets the number of 5-second ticks left before the craft leaves the base.
+	int getTakeoff() const { return _takeoff; }
 	/// Gets the craft's unique id.
 	CraftId getUniqueId() const;
 	/// Unloads the craft.
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include "SaveContainer.h"
+#include "../Engine/BinaryNode.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char SaveMagic[8] = { 'O', 'X', 'C', 'E', 'B', 'S', 'A', 'V' };
+/// Bytes of a section header: type and size.
+const size_t SectionHeaderSize = 4 + 8;
+
+}
+
+/**
+ * Creates an empty save with just the file header.
+ */
+SaveContainerWriter::SaveContainerWriter() : _data(SaveMagic, SaveMagic + sizeof(SaveMagic))
+{
+	BinaryNodeWriter writer(_data);
+	writer.writeFixed(SaveContainerReader::VERSION, 4);
+}
+
+/**
+ * Starts a section.
+ * @param type Type of the section.
+ * @return Offset of the section header.
+ */
+size_t SaveContainerWriter::beginSection(SaveSection type)
+{
+	size_t start = _data.size();
+	BinaryNodeWriter writer(_data);
+	writer.writeFixed(type, 4);
+	writer.writeFixed(0, 8);
+	return start;
+}
+
+/**
+ * Fills in the size of a section once all of it is written.
+ * @param start Offset of the section header.
+ */
+void SaveContainerWriter::endSection(size_t start)
+{
+	Uint64 size = _data.size() - start - SectionHeaderSize;
+	for (int i = 0; i < 8; ++i)
+	{
+		_data[start + 4 + i] = (unsigned char)(size >> (i * 8));
+	}
+}
+
+/**
+ * Adds a section holding a node tree.
+ * @param type Type of the section.
+ * @param node Node to store.
+ */
+void SaveContainerWriter::addNode(SaveSection type, const YAML::Node &node)
+{
+	size_t start = beginSection(type);
+	BinaryNodeWriter writer(_data);
+	writer.writeNode(node);
+	endSection(start);
+}
+
+/**
+ * Adds a section holding the elements of a sequence.
+ * @param type Type of the section.
+ * @param sequence Sequence to store, may be undefined for an empty list.
+ */
+void SaveContainerWriter::addList(SaveSection type, const YAML::Node &sequence)
+{
+	size_t start = beginSection(type);
+	BinaryNodeWriter writer(_data);
+	writer.writeVarint(sequence.size());
+	for (YAML::const_iterator i = sequence.begin(); i != sequence.end(); ++i)
+	{
+		writer.writeNode(*i);
+	}
+	endSection(start);
+}
+
+/**
+ * Adds a section of raw bytes.
+ * @param type Type of the section.
+ * @param bytes Contents of the section.
+ */
+void SaveContainerWriter::addBytes(SaveSection type, const std::vector<Uint8> &bytes)
+{
+	size_t start = beginSection(type);
+	_data.insert(_data.end(), bytes.begin(), bytes.end());
+	endSection(start);
+}
+
+/**
+ * Writes the save to a file.
+ * @param filename Full path of the file.
+ * @return True if the file was written.
+ */
+bool SaveContainerWriter::write(const std::string &filename) const
+{
+	return CrossPlatform::writeFile(filename, _data);
+}
+
+/**
+ * Opens a binary save and checks its header.
+ * @param filename Full path of the file.
+ */
+SaveContainerReader::SaveContainerReader(const std::string &filename) : _filename(filename), _file(0)
+{
+	_file = SDL_RWFromFile(filename.c_str(), "rb");
+	if (!_file)
+	{
+		std::string err = "Failed to read " + filename + ": " + SDL_GetError();
+		Log(LOG_ERROR) << err;
+		throw Exception(err);
+	}
+	// the destructor doesn't run if the constructor throws
+	unsigned char header[sizeof(SaveMagic) + 4];
+	if (SDL_RWread(_file, header, sizeof(header), 1) != 1 || memcmp(header, SaveMagic, sizeof(SaveMagic)) != 0)
+	{
+		SDL_RWclose(_file);
+		_file = 0;
+		fail("not a binary save");
+	}
+	BinaryNodeReader reader(header + sizeof(SaveMagic), header + sizeof(header));
+	Uint32 version = (Uint32)reader.readFixed(4);
+	if (version > VERSION)
+	{
+		SDL_RWclose(_file);
+		_file = 0;
+		fail("saved by a newer version (" + std::to_string(version) + ")");
+	}
+}
+
+/**
+ * Closes the save.
+ */
+SaveContainerReader::~SaveContainerReader()
+{
+	if (_file)
+	{
+		SDL_RWclose(_file);
+	}
+}
+
+/**
+ * Throws an exception about a broken file.
+ * @param reason What is wrong with it.
+ */
+void SaveContainerReader::fail(const std::string &reason) const
+{
+	std::string err = "Failed to read " + _filename + ": " + reason;
+	Log(LOG_ERROR) << err;
+	throw Exception(err);
+}
+
+/**
+ * Checks whether a file starts like a binary save.
+ * @param filename Full path of the file.
+ * @return True for binary saves, false for YAML ones.
+ */
+bool SaveContainerReader::isBinary(const std::string &filename)
+{
+	SDL_RWops *file = SDL_RWFromFile(filename.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+	char magic[sizeof(SaveMagic)];
+	bool binary = SDL_RWread(file, magic, sizeof(magic), 1) == 1 && memcmp(magic, SaveMagic, sizeof(SaveMagic)) == 0;
+	SDL_RWclose(file);
+	return binary;
+}
+
+/**
+ * Reads the next section of the save.
+ * @param type Gets the type of the section.
+ * @param payload Gets the contents of the section.
+ * @return False at the end of the file.
+ */
+bool SaveContainerReader::readSection(SaveSection &type, std::vector<unsigned char> &payload)
+{
+	unsigned char header[SectionHeaderSize];
+	size_t read = SDL_RWread(_file, header, 1, sizeof(header));
+	if (read == 0)
+	{
+		return false;
+	}
+	if (read != sizeof(header))
+	{
+		fail("truncated section");
+	}
+	BinaryNodeReader reader(header, header + sizeof(header));
+	type = (SaveSection)reader.readFixed(4);
+	Uint64 size = reader.readFixed(8);
+	if (size > 0x7FFFFFFF)
+	{
+		fail("section too large");
+	}
+	payload.resize((size_t)size);
+	if (size != 0 && SDL_RWread(_file, payload.data(), (size_t)size, 1) != 1)
+	{
+		fail("truncated section");
+	}
+	return true;
+}
+
+/**
+ * Decodes a section holding a node tree.
+ * @param payload Contents of the section.
+ * @return The node.
+ */
+YAML::Node SaveContainerReader::decodeNode(const std::vector<unsigned char> &payload) const
+{
+	BinaryNodeReader reader(payload.data(), payload.data() + payload.size());
+	YAML::Node node = reader.readNode();
+	if (!reader.ok() || !reader.atEnd())
+	{
+		fail("broken section");
+	}
+	return node;
+}
+
+/**
+ * Decodes a section holding a list.
+ * @param payload Contents of the section.
+ * @return Sequence of the elements.
+ */
+YAML::Node SaveContainerReader::decodeList(const std::vector<unsigned char> &payload) const
+{
+	BinaryNodeReader reader(payload.data(), payload.data() + payload.size());
+	YAML::Node list(YAML::NodeType::Sequence);
+	Uint64 size = reader.readVarint();
+	for (Uint64 i = 0; i < size && reader.ok(); ++i)
+	{
+		list.push_back(reader.readNode());
+	}
+	if (!reader.ok() || !reader.atEnd())
+	{
+		fail("broken section");
+	}
+	return list;
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <SDL_rwops.h>
+
+namespace OpenXcom
+{
+
+/// Types of the sections of a binary save.
+enum SaveSection
+{
+	SAVE_SECTION_BRIEF = 1,
+	SAVE_SECTION_GAME,
+	SAVE_SECTION_BATTLE,
+	SAVE_SECTION_TILES,
+	SAVE_SECTION_NODES,
+	SAVE_SECTION_UNITS,
+	SAVE_SECTION_ITEMS,
+	SAVE_SECTION_RECOVER_CONDITIONAL,
+	SAVE_SECTION_RECOVER_GUARANTEED
+};
+
+/**
+ * Writes a binary save: a magic string and version, followed by typed
+ * sections each holding their size. Node sections hold a tree in the
+ * BinaryNode form, list sections a count and one tree per element and
+ * the tile section the packed tile data as is.
+ * The brief info section always comes first, for the saves list.
+ */
+class SaveContainerWriter
+{
+	std::vector<unsigned char> _data;
+	/// Starts a section, returning where its size goes.
+	size_t beginSection(SaveSection type);
+	/// Fills in the size of a section.
+	void endSection(size_t start);
+public:
+	/// Creates an empty save.
+	SaveContainerWriter();
+	/// Adds a section holding a node tree.
+	void addNode(SaveSection type, const YAML::Node &node);
+	/// Adds a section holding the elements of a sequence.
+	void addList(SaveSection type, const YAML::Node &sequence);
+	/// Adds a section of raw bytes.
+	void addBytes(SaveSection type, const std::vector<Uint8> &bytes);
+	/// Writes the save to a file.
+	bool write(const std::string &filename) const;
+};
+
+/**
+ * Reads a binary save one section at a time, so only the section
+ * being decoded has to be in memory next to the decoded data.
+ */
+class SaveContainerReader
+{
+	std::string _filename;
+	SDL_RWops *_file;
+	/// Throws an exception about a broken file.
+	void fail(const std::string &reason) const;
+public:
+	/// Version of the binary save format.
+	static const Uint32 VERSION = 1;
+	/// Opens a binary save.
+	SaveContainerReader(const std::string &filename);
+	/// Closes the save.
+	~SaveContainerReader();
+	/// Checks whether a file is a binary save.
+	static bool isBinary(const std::string &filename);
+	/// Reads the next section, returns false at the end of the file.
+	bool readSection(SaveSection &type, std::vector<unsigned char> &payload);
+	/// Decodes a section holding a node tree.
+	YAML::Node decodeNode(const std::vector<unsigned char> &payload) const;
+	/// Decodes a section holding a list, as a sequence.
+	YAML::Node decodeList(const std::vector<unsigned char> &payload) const;
+};
+
+}
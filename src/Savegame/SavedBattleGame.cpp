@@ -42,6 +42,7 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Options.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Exception.h"
 #include "../Engine/ScriptBind.h"
 #include "SerializationHelper.h"
 #include "../Mod/RuleEnviroEffects.h"
@@ -129,8 +130,9 @@ SavedBattleGame::~SavedBattleGame()
  * @param node YAML node.
  * @param mod for the saved game.
  * @param savedGame Pointer to saved game.
+ * @param binTiles Packed tile data stored outside the node, if any.
  */
-void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGame)
+void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGame, const std::vector<Uint8> *binTiles)
 {
 	int mapsize_x = node["width"].as<int>(_mapsize_x);
 	int mapsize_y = node["length"].as<int>(_mapsize_y);
@@ -198,9 +200,21 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 		serKey.boolFields = node["tileBoolFieldsSize"].as<Uint8>(1); // boolean flags used to be stored in an unmentioned byte (Uint8) :|
 
 		// load binary tile data!
-		YAML::Binary binTiles = node["binTiles"].as<YAML::Binary>();
-
-		Uint8 *r = (Uint8*)binTiles.data();
+		YAML::Binary yamlTiles;
+		Uint8 *r;
+		if (binTiles)
+		{
+			if (binTiles->size() < totalTiles * serKey.totalBytes)
+			{
+				throw Exception("Tile data is truncated");
+			}
+			r = (Uint8*)binTiles->data();
+		}
+		else
+		{
+			yamlTiles = node["binTiles"].as<YAML::Binary>();
+			r = (Uint8*)yamlTiles.data();
+		}
 		Uint8 *dataEnd = r + totalTiles * serKey.totalBytes;
 
 		while (r < dataEnd)
@@ -450,9 +464,10 @@ void SavedBattleGame::loadMapResources(Mod *mod)
 
 /**
  * Saves the saved battle game to a YAML file.
+ * @param binTiles Gets the packed tile data instead of the node, if set.
  * @return YAML node.
  */
-YAML::Node SavedBattleGame::save() const
+YAML::Node SavedBattleGame::save(std::vector<Uint8> *binTiles) const
 {
 	YAML::Node node;
 	if (_vipSurvivalPercentage > 0)
@@ -540,7 +555,14 @@ YAML::Node SavedBattleGame::save() const
 		}
 	}
 	node["totalTiles"] = tileDataSize / Tile::serializationKey.totalBytes; // not strictly necessary, just convenient
-	node["binTiles"] = YAML::Binary(tileData, tileDataSize);
+	if (binTiles)
+	{
+		binTiles->assign(tileData, tileData + tileDataSize);
+	}
+	else
+	{
+		node["binTiles"] = YAML::Binary(tileData, tileDataSize);
+	}
 	free(tileData);
 #endif
 	for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
@@ -121,9 +121,9 @@ public:
 	/// Cleans up the saved game.
 	~SavedBattleGame();
 	/// Loads a saved battle game from YAML.
-	void load(const YAML::Node& node, Mod *mod, SavedGame* savedGame);
+	void load(const YAML::Node& node, Mod *mod, SavedGame* savedGame, const std::vector<Uint8> *binTiles = 0);
 	/// Saves a saved battle game to YAML.
-	YAML::Node save() const;
+	YAML::Node save(std::vector<Uint8> *binTiles = 0) const;
 	/// Sets the dimensions of the map and initializes it.
 	void initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool resetTerrain = true);
 	/// Initialises the pathfinding and tile engine.
@@ -33,6 +33,7 @@
 #include "../Engine/CrossPlatform.h"
 #include "../Engine/ScriptBind.h"
 #include "SavedBattleGame.h"
+#include "SaveContainer.h"
 #include "SerializationHelper.h"
 #include "GameTime.h"
 #include "Country.h"
@@ -114,6 +115,102 @@ bool equalProduction::operator()(const Production * p) const
 	return p->getRules() == _item;
 }
 
+/// Battlescape lists kept in their own sections of binary saves.
+const std::pair<const char*, SaveSection> BattleListSections[] =
+{
+	{ "nodes", SAVE_SECTION_NODES },
+	{ "units", SAVE_SECTION_UNITS },
+	{ "items", SAVE_SECTION_ITEMS },
+	{ "recoverConditional", SAVE_SECTION_RECOVER_CONDITIONAL },
+	{ "recoverGuaranteed", SAVE_SECTION_RECOVER_GUARANTEED },
+};
+
+/**
+ * Reads a binary save one section at a time, putting the battlescape
+ * lists back where a YAML save would have them.
+ * @param filepath Full path of the save.
+ * @param binTiles Gets the packed tile data.
+ * @return The brief info and full save data, like in a YAML save.
+ */
+static std::vector<YAML::Node> loadBinarySave(const std::string &filepath, std::vector<Uint8> &binTiles)
+{
+	SaveContainerReader reader(filepath);
+	YAML::Node brief, doc, battle;
+	std::vector<std::pair<const char*, YAML::Node> > lists;
+	SaveSection type;
+	std::vector<unsigned char> payload;
+	while (reader.readSection(type, payload))
+	{
+		switch (type)
+		{
+		case SAVE_SECTION_BRIEF:
+			brief = reader.decodeNode(payload);
+			break;
+		case SAVE_SECTION_GAME:
+			doc = reader.decodeNode(payload);
+			break;
+		case SAVE_SECTION_BATTLE:
+			battle = reader.decodeNode(payload);
+			break;
+		case SAVE_SECTION_TILES:
+			binTiles.swap(payload);
+			break;
+		default:
+			for (const auto &list : BattleListSections)
+			{
+				if (list.second == type)
+				{
+					lists.push_back(std::make_pair(list.first, reader.decodeList(payload)));
+				}
+			}
+			break;
+		}
+	}
+	if (battle.IsMap())
+	{
+		for (const auto &list : lists)
+		{
+			battle[list.first] = list.second;
+		}
+		doc["battleGame"] = battle;
+	}
+	return { brief, doc };
+}
+
+/**
+ * Writes a save with a battle in progress as a binary save.
+ * @param filepath Full path of the save.
+ * @param brief Brief info for the saves list.
+ * @param doc Full save data, including the battle.
+ * @param binTiles Packed tile data of the battle.
+ * @return True if the file was written.
+ */
+static bool saveBinarySave(const std::string &filepath, const YAML::Node &brief, YAML::Node doc, const std::vector<Uint8> &binTiles)
+{
+	YAML::Node battle = doc["battleGame"];
+	doc.remove("battleGame");
+	std::vector<std::pair<SaveSection, YAML::Node> > lists;
+	for (const auto &list : BattleListSections)
+	{
+		if (battle[list.first])
+		{
+			lists.push_back(std::make_pair(list.second, battle[list.first]));
+			battle.remove(list.first);
+		}
+	}
+
+	SaveContainerWriter writer;
+	writer.addNode(SAVE_SECTION_BRIEF, brief);
+	writer.addNode(SAVE_SECTION_GAME, doc);
+	writer.addNode(SAVE_SECTION_BATTLE, battle);
+	writer.addBytes(SAVE_SECTION_TILES, binTiles);
+	for (const auto &list : lists)
+	{
+		writer.addList(list.first, list.second);
+	}
+	return writer.write(filepath);
+}
+
 bool researchLess(const RuleResearch *a, const RuleResearch *b)
 {
 	return std::less<const RuleResearch *>{}(a, b);
@@ -327,7 +424,23 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 {
 	std::string fullname = Options::getMasterUserFolder() + file;
-	YAML::Node doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+	YAML::Node doc;
+	if (SaveContainerReader::isBinary(fullname))
+	{
+		// the brief info is always the first section
+		SaveContainerReader reader(fullname);
+		SaveSection type;
+		std::vector<unsigned char> payload;
+		if (!reader.readSection(type, payload) || type != SAVE_SECTION_BRIEF)
+		{
+			throw Exception(file + " has no brief info section");
+		}
+		doc = reader.decodeNode(payload);
+	}
+	else
+	{
+		doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+	}
 	SaveInfo save;
 
 	save.fileName = file;
@@ -399,7 +512,9 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 {
 	std::string filepath = Options::getMasterUserFolder() + filename;
-	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filepath));
+	std::vector<Uint8> binTiles;
+	const bool binary = SaveContainerReader::isBinary(filepath);
+	std::vector<YAML::Node> file = binary ? loadBinarySave(filepath, binTiles) : YAML::LoadAll(*CrossPlatform::readFile(filepath));
 	// Get brief save info
 	YAML::Node brief = file[0];
 	_time->load(brief["time"]);
@@ -773,7 +888,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 	if (const YAML::Node &battle = doc["battleGame"])
 	{
 		_battleGame = new SavedBattleGame(mod, lang);
-		_battleGame->load(battle, mod, this);
+		_battleGame->load(battle, mod, this, binary ? &binTiles : 0);
 	}
 
 	_scriptValues.load(doc, mod->getScriptGlobal());
@@ -816,9 +931,7 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	brief["mods"] = modsList;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
 	// Saves the full game data to the save
-	out << YAML::BeginDoc;
 	YAML::Node node;
 	node["difficulty"] = (int)_difficulty;
 	node["end"] = (int)_end;
@@ -948,16 +1061,29 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	{
 		node["autoSales"].push_back((*i)->getName());
 	}
+	// battles in progress are big, they go into a binary save unless YAML is wanted
+	const bool binary = _battleGame != 0 && Options::oxceBinaryBattleSaves;
+	std::vector<Uint8> binTiles;
 	if (_battleGame != 0)
 	{
-		node["battleGame"] = _battleGame->save();
+		node["battleGame"] = _battleGame->save(binary ? &binTiles : 0);
 	}
 	_scriptValues.save(node, mod->getScriptGlobal());
 
-	out << node;
+	std::string filepath = Options::getMasterUserFolder() + filename;
+	if (binary)
+	{
+		if (!saveBinarySave(filepath, brief, node, binTiles))
+		{
+			throw Exception("Failed to save " + filepath);
+		}
+		return;
+	}
 
+	out << brief;
+	out << YAML::BeginDoc;
+	out << node;
 
-	std::string filepath = Options::getMasterUserFolder() + filename;
 	if (!CrossPlatform::writeFile(filepath, out.c_str()))
 	{
 		throw Exception("Failed to save " + filepath);
@@ -37,6 +37,9 @@
 namespace OpenXcom
 {
 
+Uint32 Tile::_terrainRevision = 0;
+Uint32 Tile::_viewRevision = 0;
+
 /// How many bytes various fields use in a serialized tile. See header.
 Tile::SerializationKey Tile::serializationKey =
 {4, // index
@@ -110,6 +113,7 @@ void Tile::load(const YAML::Node &node)
 	{
 		_objectsCache[2].currentFrame = 7;
 	}
+	terrainChanged();
 	if (_fire || _smoke)
 	{
 		_animationOffset = RNG::seedless(0, 3);
@@ -141,6 +145,7 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_objectsCache[O_FLOOR].discovered = (boolFields & 4) ? 1 : 0;
 	_objectsCache[O_WESTWALL].currentFrame = (boolFields & 8) ? 7 : 0;
 	_objectsCache[O_NORTHWALL].currentFrame = (boolFields & 0x10) ? 7 : 0;
+	terrainChanged();
 	if (_fire || _smoke)
 	{
 		_animationOffset = RNG::seedless(0, 3);
@@ -224,6 +229,7 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart pa
 	_objectsCache[part].isUfoDoor = dat ? dat->isUFODoor() : 0;
 	_objectsCache[part].offsetY = dat ? dat->getYOffset() : 0;
 	_objectsCache[part].isBackTileObject = dat ? dat->isBackTileObject() : 0;
+	terrainChanged();
 	if (part == O_FLOOR || part == O_OBJECT)
 	{
 		int level = 0;
@@ -377,6 +383,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 		if (unit && cost.Time && !cost.haveTU())
 			return 4;
 		_objectsCache[part].currentFrame = 1; // start opening door
+		terrainChanged();
 		updateSprite((TilePart)part);
 		return 1;
 	}
@@ -396,6 +403,7 @@ int Tile::closeUfoDoor()
 		if (isUfoDoorOpen((TilePart)part))
 		{
 			_objectsCache[part].currentFrame = 0;
+			terrainChanged();
 			retval = 1;
 			updateSprite((TilePart)part);
 		}
@@ -419,6 +427,7 @@ void Tile::setDiscovered(bool flag, TilePart part)
 			_objectsCache[O_WESTWALL].discovered = true;
 			_objectsCache[O_NORTHWALL].discovered = true;
 		}
+		viewChanged();
 	}
 }
 
@@ -439,7 +448,11 @@ bool Tile::isDiscovered(TilePart part) const
  */
 void Tile::resetLight(LightLayers layer)
 {
-	_light[layer] = 0;
+	if (_light[layer] != 0)
+	{
+		_light[layer] = 0;
+		viewChanged();
+	}
 }
 
 /**
@@ -450,7 +463,11 @@ void Tile::resetLightMulti(LightLayers layer)
 {
 	for (int l = layer; l < LL_MAX; l++)
 	{
-		_light[l] = 0;
+		if (_light[l] != 0)
+		{
+			_light[l] = 0;
+			viewChanged();
+		}
 	}
 }
 
@@ -462,7 +479,10 @@ void Tile::resetLightMulti(LightLayers layer)
 void Tile::addLight(int light, LightLayers layer)
 {
 	if (_light[layer] < light)
+	{
 		_light[layer] = light;
+		viewChanged();
+	}
 }
 
 /**
@@ -665,6 +685,7 @@ void Tile::ignite(int power)
 				_overlaps = 1;
 				_fire = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
+				viewChanged();
 			}
 		}
 	}
@@ -674,9 +695,11 @@ void Tile::ignite(int power)
  * Animate the tile. This means to advance the current frame for every object.
  * Ufo doors are a bit special, they animated only when triggered.
  * When ufo doors are on frame 0(closed) or frame 7(open) they are not animated further.
+ * @return True if the sprite of any part changed.
  */
-void Tile::animate()
+bool Tile::animate()
 {
+	bool changed = false;
 	int newframe;
 	for (int i = O_FLOOR; i < O_MAX; ++i)
 	{
@@ -695,10 +718,19 @@ void Tile::animate()
 			{
 				newframe = 0;
 			}
+			if (_objects[i]->getSprite(newframe) != _objects[i]->getSprite(_objectsCache[i].currentFrame))
+			{
+				changed = true;
+			}
 			_objectsCache[i].currentFrame = newframe;
+			if (_objectsCache[i].isUfoDoor && newframe == 2) // from here on the door can be walked through
+			{
+				terrainChanged();
+			}
 		}
 		updateSprite((TilePart)i);
 	}
+	return changed;
 }
 
 /**
@@ -744,6 +776,7 @@ void Tile::setFire(int fire)
 {
 	_fire = Clamp(fire, 0, 255);
 	_animationOffset = RNG::generate(0,3);
+	viewChanged();
 }
 
 /**
@@ -773,6 +806,7 @@ void Tile::addSmoke(int smoke)
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
+		viewChanged();
 	}
 }
 
@@ -784,6 +818,7 @@ void Tile::setSmoke(int smoke)
 {
 	_smoke = Clamp(smoke, 0, 255);
 	_animationOffset = RNG::generate(0,3);
+	viewChanged();
 }
 
 
@@ -822,6 +857,7 @@ void Tile::addItem(BattleItem *item, RuleInventory *ground)
 	{
 		std::swap(_inventory.front(), _inventory.back());
 	}
+	viewChanged();
 }
 
 /**
@@ -839,6 +875,7 @@ void Tile::removeItem(BattleItem *item)
 		}
 	}
 	item->setTile(0);
+	viewChanged();
 }
 
 /**
@@ -913,6 +950,7 @@ void Tile::prepareNewTurn(bool smokeDamage)
 	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
 	{
 		_smoke = Clamp((_smoke / _overlaps) - 1, 0, 15);
+		viewChanged();
 	}
 	// if we still have smoke/fire
 	if (_smoke)
@@ -942,7 +980,11 @@ std::vector<BattleItem *> *Tile::getInventory()
  */
 void Tile::setMarkerColor(int color)
 {
-	_markerColor = color;
+	if (_markerColor != color)
+	{
+		_markerColor = color;
+		viewChanged();
+	}
 }
 
 /**
@@ -978,7 +1020,11 @@ int Tile::getVisible() const
  */
 void Tile::setPreview(int dir)
 {
-	_preview = dir;
+	if (_preview != dir)
+	{
+		_preview = dir;
+		viewChanged();
+	}
 }
 
 /**
@@ -996,7 +1042,11 @@ int Tile::getPreview() const
  */
 void Tile::setTUMarker(int tu)
 {
-	_TUMarker = tu;
+	if (_TUMarker != tu)
+	{
+		_TUMarker = tu;
+		viewChanged();
+	}
 }
 
 /**
@@ -1047,7 +1097,11 @@ bool Tile::getDangerous() const
  */
 void Tile::setObstacle(int part)
 {
-	_obstacle |= (1 << part);
+	if (!(_obstacle & (1 << part)))
+	{
+		_obstacle |= (1 << part);
+		viewChanged();
+	}
 }
 
 /**
@@ -1055,7 +1109,11 @@ void Tile::setObstacle(int part)
  */
 void Tile::resetObstacle(void)
 {
-	_obstacle = 0;
+	if (_obstacle != 0)
+	{
+		_obstacle = 0;
+		viewChanged();
+	}
 }
 
 
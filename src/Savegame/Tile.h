@@ -127,6 +127,22 @@ protected:
 	int _preview;
 	int _TUMarker;
 	int _overlaps;
+	int _voxelShape = NOT_CALCULATED;
+	Uint32 _terrainChangedAt = 0;
+	static Uint32 _terrainRevision;
+	static Uint32 _viewRevision;
+
+	/// Marks data cached from the tile parts as outdated.
+	void terrainChanged()
+	{
+		_voxelShape = NOT_CALCULATED;
+		_terrainChangedAt = ++_terrainRevision;
+	}
+	/// Marks a change in how the tile is drawn that isn't a change of its parts.
+	static void viewChanged()
+	{
+		++_viewRevision;
+	}
 
 
 public:
@@ -269,6 +285,16 @@ public:
 
 	/// Close ufo door.
 	int closeUfoDoor();
+	/// Gets the index of the cached voxel shape of this tile.
+	int getVoxelShape() const { return _voxelShape; }
+	/// Sets the index of the cached voxel shape of this tile.
+	void setVoxelShape(int shape) { _voxelShape = shape; }
+	/// Gets a counter that changes whenever parts or doors of any tile change.
+	static Uint32 getTerrainRevision() { return _terrainRevision; }
+	/// Gets the terrain revision of the last change to this tile.
+	Uint32 getTerrainChangedAt() const { return _terrainChangedAt; }
+	/// Gets a counter that changes whenever fog of war, light, fire, smoke, items or path markers of any tile change.
+	static Uint32 getViewRevision() { return _viewRevision; }
 	/// Sets the black fog of war status of this tile.
 	void setDiscovered(bool flag, TilePart part);
 	/// Gets the black fog of war status of this tile.
@@ -296,7 +322,7 @@ public:
 	/// Get explosive power of this tile.
 	int getExplosiveType() const;
 	/// Animated the tile parts.
-	void animate();
+	bool animate();
 	/// Update cached value of sprite.
 	void updateSprite(TilePart part);
 	/// Get object sprites.
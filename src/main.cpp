@@ -26,6 +26,11 @@
 #include "Engine/Options.h"
 #include "Engine/FileMap.h"
 #include "Menu/StartState.h"
+#include "Battlescape/BattleBenchmark.h"
+#include "Geoscape/GeoscapeBenchmark.h"
+#include "Engine/BlitBenchmark.h"
+#include "Engine/ScalerBenchmark.h"
+#include "Mod/ScriptBenchmark.h"
 
 /** @mainpage
  * @author OpenXcom Developers
@@ -117,10 +122,54 @@ int main(int argc, char *argv[])
 	Options::baseXResolution = Options::displayWidth;
 	Options::baseYResolution = Options::displayHeight;
 
+	if (Options::getBlitBenchmark() > 0)
+	{
+		// only works on memory buffers, no need for the game at all
+		BlitBenchmark blitBenchmark(Options::getBlitBenchmark());
+		return blitBenchmark.run();
+	}
+	if (Options::getScalerBenchmark() > 0)
+	{
+		// same, the scalers only need the worker pool
+		ScalerBenchmark scalerBenchmark(Options::getScalerBenchmark());
+		return scalerBenchmark.run();
+	}
+	if (Options::getScriptBenchmark() > 0)
+	{
+		// the scripts are parsed by a bare ruleset, no mods are loaded
+		ScriptBenchmark scriptBenchmark(Options::getScriptBenchmark());
+		return scriptBenchmark.run();
+	}
+
+	bool benchmark = !Options::getBattleBenchmark().empty() || !Options::getGeoscapeBenchmark().empty();
+	if (benchmark)
+	{
+		// no window, no sound card, nothing to wait for
+		SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+		SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+		Options::useOpenGL = false;
+		Options::fullscreen = false;
+		Options::borderless = false;
+	}
+
 	game = new Game(title.str());
 	State::setGamePtr(game);
-	game->setState(new StartState);
-	game->run();
+	int exitCode = EXIT_SUCCESS;
+	if (!Options::getGeoscapeBenchmark().empty())
+	{
+		GeoscapeBenchmark geoscapeBenchmark(game, Options::getGeoscapeBenchmark(), Options::getBenchmarkDays(), Options::getBenchmarkSeed());
+		exitCode = geoscapeBenchmark.run();
+	}
+	else if (benchmark)
+	{
+		BattleBenchmark battleBenchmark(game, Options::getBattleBenchmark(), Options::getBenchmarkTurns(), Options::getBenchmarkSeed());
+		exitCode = battleBenchmark.run();
+	}
+	else
+	{
+		game->setState(new StartState);
+		game->run();
+	}
 
 	bool startUpdate = game->getUpdateFlag();
 
@@ -133,7 +182,7 @@ int main(int argc, char *argv[])
 		CrossPlatform::startUpdateProcess();
 	}
 
-	return EXIT_SUCCESS;
+	return exitCode;
 }
 
 namespace OpenXcom